@@ -0,0 +1,51 @@
+#ifndef INK_UTILITY_ALIGNED_ALLOCATOR_HEADER_FILE_GUARD
+#define INK_UTILITY_ALIGNED_ALLOCATOR_HEADER_FILE_GUARD
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+namespace ink {
+	
+	namespace detail {
+		
+		/**
+		 * Minimal allocator handing out storage aligned to at least Alignment bytes (a cache line by default),
+		 * so that each column of a Vector2Array or soa_vector starts on a boundary every SIMD load width divides evenly.
+		 */
+		template<typename T, size_t Alignment = 64>
+		struct AlignedAllocator
+		{
+			using value_type = T;
+			static constexpr size_t alignment = Alignment > alignof(T) ? Alignment : alignof(T);
+			
+			template<typename U> struct
+			rebind { using other = AlignedAllocator<U, Alignment>; };
+			
+			constexpr AlignedAllocator() noexcept = default;
+			
+			template<typename U> constexpr
+			AlignedAllocator(AlignedAllocator<U, Alignment> const&) noexcept {}
+			
+			[[nodiscard]] T*
+			allocate(size_t n)
+			{ return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t{ alignment })); }
+			
+			void
+			deallocate(T* p, size_t)
+			{ ::operator delete(p, std::align_val_t{ alignment }); }
+			
+			template<typename U> constexpr bool
+			operator==(AlignedAllocator<U, Alignment> const&) const noexcept
+			{ return true; }
+			
+		};
+		
+		template<typename T> using
+		AlignedVector = std::vector<T, AlignedAllocator<T>>;
+		
+	}
+	
+}
+
+#endif
@@ -0,0 +1,106 @@
+#ifndef INK_UTILITY_BENCHMARK_HEADER_FILE_GUARD
+#define INK_UTILITY_BENCHMARK_HEADER_FILE_GUARD
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <initializer_list>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * The timing loop and JSON output shared by the benchmarks in this directory.
+ * Every benchmark writes a single JSON document to stdout:
+ * 	{ <header fields>, "results": [ { "name": ..., "ns_per_element": ..., <extra fields> }, ... ] }
+ * where "ns_per_element" is the best of all repetitions, divided by the elements the benchmark names in its header.
+ */
+namespace ink::benchmark {
+	
+	using Clock = std::chrono::steady_clock;
+	
+	struct Result
+	{
+		std::string name;
+		double ns_per_element = 0;
+	};
+	
+	// One "name": value pair of the document's header.
+	struct Field
+	{
+		const char* name;
+		size_t value;
+	};
+	
+	// Nanoseconds from start until now.
+	inline double
+	Since(Clock::time_point start)
+	{ return std::chrono::duration<double, std::nano>(Clock::now() - start).count(); }
+	
+	/**
+	 * Best time of repetitions calls to run(), in nanoseconds.
+	 * If run() returns a double, it does its own setup and returns the nanoseconds it spent on what is measured;
+	 * otherwise the whole call is timed.
+	 */
+	template<typename Run> double
+	Best(size_t repetitions, Run&& run)
+	{
+		double best = 1e300;
+		for (size_t rep = 0; rep < repetitions; rep++)
+		{
+			if constexpr (std::is_same_v<std::invoke_result_t<Run&>, double>)
+				best = std::min(best, run());
+			else
+			{
+				const auto start = Clock::now();
+				run();
+				best = std::min(best, Since(start));
+			}
+		}
+		return best;
+	}
+	
+	// Best(repetitions, run), per element, under name.
+	template<typename Run> Result
+	Measure(std::string name, size_t elements, size_t repetitions, Run&& run)
+	{ return { std::move(name), Best(repetitions, std::forward<Run>(run)) / double(elements) }; }
+	
+	// The fields of a plain Result.
+	inline void
+	PrintEntry(Result const& result)
+	{ std::printf("\"name\": \"%s\", \"ns_per_element\": %.4f", result.name.c_str(), result.ns_per_element); }
+	
+	/**
+	 * Writes the document: the header fields, then one entry per result, whose fields between the braces are written by
+	 * entry(result), then whatever trailer() writes: further members of the document, each starting with ",\n".
+	 */
+	template<typename R, typename Entry, typename Trailer> void
+	Print(std::initializer_list<Field> header, std::vector<R> const& results, Entry&& entry, Trailer&& trailer)
+	{
+		std::printf("{\n");
+		for (auto const& field : header) std::printf("\t\"%s\": %zu,\n", field.name, field.value);
+		std::printf("\t\"results\": [\n");
+		for (size_t r = 0; r < results.size(); r++)
+		{
+			std::printf("\t\t{ ");
+			entry(results[r]);
+			std::printf(" }%s\n", r + 1 < results.size() ? "," : "");
+		}
+		std::printf("\t]");
+		trailer();
+		std::printf("\n}\n");
+	}
+	
+	template<typename R, typename Entry> void
+	Print(std::initializer_list<Field> header, std::vector<R> const& results, Entry&& entry)
+	{ Print(header, results, std::forward<Entry>(entry), [] {}); }
+	
+	inline void
+	Print(std::initializer_list<Field> header, std::vector<Result> const& results)
+	{ Print(header, results, PrintEntry); }
+	
+}
+
+#endif
@@ -0,0 +1,114 @@
+/**
+ * Throughput benchmark for ink::visit, against std::visit, over std::variants of 4, 16 and 64 alternatives.
+ * Build from the repository root with, e.g.
+ * 	g++ -std=c++20 -O2 -I. Benchmarks/Dispatch_Benchmark.cpp -o Dispatch_Benchmark
+ *
+ * Each run visits ELEMENTS variants in a row, summing a small per-alternative computation. The alternatives are laid out
+ * in three patterns, from perfectly predictable to not at all:
+ * 	+ "constant": every variant holds the same alternative.
+ * 	+ "cyclic": alternatives come round in order, 0, 1, ... N-1, 0, ...
+ * 	+ "random": uniformly random alternatives.
+ * The results are written to stdout as a single JSON document, with one entry per (alternatives, pattern, method),
+ * holding "ns_per_element": best of all repetitions.
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <variant>
+#include <vector>
+
+#include "Benchmark.hpp"
+#include "Dispatch.hpp"
+
+namespace {
+	
+	constexpr size_t ELEMENTS = size_t(1) << 16;
+	constexpr size_t REPETITIONS = 64;
+	
+	using namespace ink::benchmark;
+	
+	template<size_t I> struct
+	alt
+	{
+		uint32_t v = 0;
+		
+		// Something different per alternative, so that no two of them fold into one.
+		uint32_t
+		work() const
+		{ return v * uint32_t(2 * I + 1) + uint32_t(I); }
+	};
+	
+	template<typename Sequence> struct
+	make_variant;
+	
+	template<size_t... I> struct
+	make_variant<std::index_sequence<I...>>
+	{ using type = std::variant<alt<I>...>; };
+	
+	template<typename Variant, typename Visit> Result
+	measure(std::string name, std::vector<Variant> const& variants, Visit&& visit)
+	{
+		return Measure(std::move(name), variants.size(), REPETITIONS, [&]
+		{
+			uint32_t sum = 0;
+			for (auto const& v : variants) sum += visit(v);
+			
+			// Keep the optimizer from discarding the loop.
+			volatile uint32_t sink = sum; (void)sink;
+		});
+	}
+	
+	template<size_t N> std::vector<typename make_variant<std::make_index_sequence<N>>::type>
+	make_variants(std::string const& pattern)
+	{
+		using Variant = typename make_variant<std::make_index_sequence<N>>::type;
+		std::mt19937_64 rng(N);
+		std::uniform_int_distribution<size_t> any(0, N - 1);
+		
+		std::vector<Variant> variants(ELEMENTS);
+		for (size_t i = 0; i < ELEMENTS; i++)
+		{
+			const size_t index = pattern == "constant" ? N / 2 : pattern == "cyclic" ? i % N : any(rng);
+			ink::dispatch_index<N>(index, [&]<size_t I>(std::integral_constant<size_t, I>) { variants[i].template emplace<I>(alt<I>{ uint32_t(i) }); });
+		}
+		return variants;
+	}
+	
+	template<size_t N> void
+	run(std::vector<Result>& results)
+	{
+		const auto work = [](auto const& a) { return a.work(); };
+		
+		for (std::string pattern : { "constant", "cyclic", "random" })
+		{
+			const auto variants = make_variants<N>(pattern);
+			const auto prefix = "alternatives=" + std::to_string(N) + "/" + pattern + "/";
+			
+			results.push_back(measure(prefix + "std::visit", variants, [&](auto const& v) { return std::visit(work, v); }));
+			results.push_back(measure(prefix + "ink::visit", variants, [&](auto const& v) { return ink::visit(work, v); }));
+			results.push_back(measure(prefix + "ink::visit[table]", variants,
+				[&](auto const& v) { return ink::visit<ink::dispatch_strategy::table>(work, v); }));
+			
+			if constexpr (N <= 16)
+			{
+				results.push_back(measure(prefix + "ink::visit[switch]", variants,
+					[&](auto const& v) { return ink::visit<ink::dispatch_strategy::switch_>(work, v); }));
+			}
+		}
+	}
+	
+}
+
+int
+main()
+{
+	std::vector<Result> results;
+	
+	run<4>(results);
+	run<16>(results);
+	run<64>(results);
+	
+	Print({ { "elements", ELEMENTS }, { "repetitions", REPETITIONS } }, results);
+}
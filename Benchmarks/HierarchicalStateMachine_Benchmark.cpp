@@ -0,0 +1,220 @@
+/**
+ * Dispatch benchmark for ink::hsm::StateMachine, against the same hierarchical machine written by hand as nested switches.
+ * Build from the repository root with, e.g.
+ * 	g++ -std=c++20 -O2 -I. Benchmarks/HierarchicalStateMachine_Benchmark.cpp -o HierarchicalStateMachine_Benchmark
+ *
+ * The machine is an actor's: Alive { Idle, Moving { Walk, Run }, Combat { Aim, Fire } } and Dead, on 7 events, with
+ * entry and exit functions on most states, a guarded transition, and transitions inherited from outer states.
+ * ACTORS actors, each with its own machine, get EVENTS events, in two patterns:
+ * 	+ "cyclic": every actor gets the events in the same repeating order.
+ * 	+ "random": uniformly random events, to uniformly random actors.
+ * Each pattern is dispatched with:
+ * 	+ "switch": a switch on the outer state, then on the inner ones, then on the event.
+ * 	+ "hsm": StateMachine::Dispatch, through its flattened [leaf][event] table.
+ * Both sides must end with the same counters; the benchmark fails otherwise.
+ * The results are written to stdout as a single JSON document, with one entry per (pattern, method), holding
+ * "ns_per_element": best of all repetitions, per event.
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Benchmark.hpp"
+#include "HierarchicalStateMachine.hpp"
+
+namespace {
+	
+	constexpr size_t ACTORS = size_t(1) << 12;
+	constexpr size_t EVENTS = size_t(1) << 16;
+	constexpr size_t REPETITIONS = 64;
+	
+	using namespace ink::benchmark;
+	
+	// What the entry, exit and transition functions touch.
+	struct Actor
+	{
+		uint32_t ammo = 3;
+		uint32_t speed = 0;
+		uint32_t hits = 0;
+		uint32_t trace = 0;		// Every function folds a different constant into this, so that none of them fold into another.
+		
+		void
+		mark(uint32_t what)
+		{ trace = trace * 33 + what; }
+	};
+	
+	enum Event : uint8_t { Go, Faster, Stop, Spot, Shoot, Hit, Revive, EVENT_COUNT };
+	
+	/* The machine, as types */
+	
+	struct Idle; struct Walk; struct Aim;
+	struct Alive	{ using initial = Idle;							static void entry(Actor& a) { a.mark(1); a.hits = 0; }		static void exit(Actor& a) { a.mark(2); } };
+	struct Idle		{ using parent = Alive;							static void entry(Actor& a) { a.mark(3); } };
+	struct Moving	{ using parent = Alive; using initial = Walk;	static void entry(Actor& a) { a.mark(4); a.speed = 1; }		static void exit(Actor& a) { a.mark(5); a.speed = 0; } };
+	struct Walk		{ using parent = Moving; };
+	struct Run		{ using parent = Moving;						static void entry(Actor& a) { a.mark(6); a.speed = 2; } };
+	struct Combat	{ using parent = Alive; using initial = Aim;	static void entry(Actor& a) { a.mark(7); }					static void exit(Actor& a) { a.mark(8); } };
+	struct Aim		{ using parent = Combat; };
+	struct Fire		{ using parent = Combat;						static void entry(Actor& a) { a.mark(9); a.ammo--; } };
+	struct Dead		{												static void entry(Actor& a) { a.mark(10); } };
+	
+	struct GoEvent {}; struct FasterEvent {}; struct StopEvent {}; struct SpotEvent {}; struct ShootEvent {}; struct HitEvent {}; struct ReviveEvent {};
+	
+	void Reload(Actor& a) { a.mark(11); a.ammo = 3; }
+	void Hurt(Actor& a) { a.mark(12); a.hits++; }
+	bool Armed(Actor const& a) { return a.ammo > 0; }
+	bool Fatal(Actor const& a) { return a.hits >= 2; }
+	
+	using Machine = ink::hsm::StateMachine<Actor,
+		ink::rebind::type_list<Alive, Idle, Moving, Walk, Run, Combat, Aim, Fire, Dead>,
+		ink::rebind::type_list<GoEvent, FasterEvent, StopEvent, SpotEvent, ShootEvent, HitEvent, ReviveEvent>,
+		ink::rebind::type_list<
+			ink::hsm::Transition<Idle, GoEvent, Moving>,
+			ink::hsm::Transition<Walk, FasterEvent, Run>,
+			ink::hsm::Transition<Moving, StopEvent, Idle>,
+			ink::hsm::Transition<Combat, StopEvent, Idle, &Reload>,
+			ink::hsm::Transition<Alive, SpotEvent, Combat>,
+			ink::hsm::Transition<Aim, ShootEvent, Fire, nullptr, &Armed>,
+			ink::hsm::Transition<Fire, ShootEvent, Aim>,
+			ink::hsm::Transition<Alive, HitEvent, Dead, nullptr, &Fatal>,
+			ink::hsm::Transition<Alive, HitEvent, ink::hsm::Internal, &Hurt>,
+			ink::hsm::Transition<Dead, ReviveEvent, Alive>
+		>>;
+	
+	/* The same machine, by hand */
+	
+	struct SwitchMachine
+	{
+		enum class Top : uint8_t { Alive, Dead } top = Top::Alive;
+		enum class Sub : uint8_t { Idle, Moving, Combat } sub = Sub::Idle;
+		enum class Leaf : uint8_t { Walk, Run, Aim, Fire } leaf = Leaf::Walk;
+		
+		void
+		Start(Actor& a)
+		{ a.mark(1); a.hits = 0; a.mark(3); top = Top::Alive; sub = Sub::Idle; }
+		
+		// Leaves Alive and all of its states, innermost first, from wherever the machine is within it.
+		void
+		ExitAlive(Actor& a)
+		{
+			if (sub == Sub::Moving) { a.mark(5); a.speed = 0; }
+			if (sub == Sub::Combat) a.mark(8);
+			a.mark(2);
+		}
+		
+		void
+		Dispatch(Event event, Actor& a)
+		{
+			switch (top)
+			{
+				case Top::Alive:
+					// Handled by the inner states first...
+					switch (sub)
+					{
+						case Sub::Idle:
+							if (event == Go) { a.mark(4); a.speed = 1; sub = Sub::Moving; leaf = Leaf::Walk; return; }
+							break;
+						case Sub::Moving:
+							switch (leaf)
+							{
+								case Leaf::Walk:
+									if (event == Faster) { a.mark(6); a.speed = 2; leaf = Leaf::Run; return; }
+									break;
+								default: break;
+							}
+							if (event == Stop) { a.mark(5); a.speed = 0; a.mark(3); sub = Sub::Idle; return; }
+							break;
+						case Sub::Combat:
+							switch (leaf)
+							{
+								case Leaf::Aim:
+									if (event == Shoot && a.ammo > 0) { a.mark(9); a.ammo--; leaf = Leaf::Fire; return; }
+									break;
+								case Leaf::Fire:
+									if (event == Shoot) { leaf = Leaf::Aim; return; }
+									break;
+								default: break;
+							}
+							if (event == Stop) { a.mark(8); a.mark(11); a.ammo = 3; a.mark(3); sub = Sub::Idle; return; }
+							break;
+					}
+					// ...then by Alive.
+					switch (event)
+					{
+						case Spot: ExitAlive(a); a.mark(1); a.hits = 0; a.mark(7); sub = Sub::Combat; leaf = Leaf::Aim; return;	// Alive is left and entered again.
+						case Hit:
+							if (a.hits >= 2) { ExitAlive(a); a.mark(10); top = Top::Dead; return; }
+							a.mark(12); a.hits++; return;
+						default: return;
+					}
+				case Top::Dead:
+					if (event == Revive) { a.mark(1); a.hits = 0; a.mark(3); top = Top::Alive; sub = Sub::Idle; }
+					return;
+			}
+		}
+	};
+	
+	struct Delivery
+	{
+		uint32_t actor;
+		Event event;
+	};
+	
+	// Runs every delivery from a fresh start of every actor, and returns the best time, and a checksum of the actors.
+	template<typename M> Result
+	measure(std::string name, std::vector<Delivery> const& deliveries, uint64_t& checksum)
+	{
+		return Measure(std::move(name), EVENTS, REPETITIONS, [&]
+		{
+			std::vector<Actor> actors(ACTORS);
+			std::vector<M> machines(ACTORS);
+			for (size_t i = 0; i < ACTORS; i++) machines[i].Start(actors[i]);
+			
+			const auto start = Clock::now();
+			for (Delivery d : deliveries) machines[d.actor].Dispatch(d.event, actors[d.actor]);
+			const double elapsed = Since(start);
+			
+			checksum = 0;
+			for (Actor const& a : actors) checksum = checksum * 31 + a.trace + a.ammo + a.speed + a.hits;
+			return elapsed;
+		});
+	}
+	
+}
+
+int
+main()
+{
+	std::mt19937_64 rng(EVENTS);
+	std::uniform_int_distribution<uint32_t> any_actor(0, ACTORS - 1);
+	std::uniform_int_distribution<int> any_event(0, EVENT_COUNT - 1);
+	
+	std::vector<Result> results;
+	bool same = true;
+	
+	for (std::string pattern : { "cyclic", "random" })
+	{
+		std::vector<Delivery> deliveries(EVENTS);
+		for (size_t i = 0; i < EVENTS; i++)
+		{
+			deliveries[i] = pattern == "cyclic"
+				? Delivery{ uint32_t(i % ACTORS), Event((i / ACTORS) % EVENT_COUNT) }
+				: Delivery{ any_actor(rng), Event(any_event(rng)) };
+		}
+		
+		uint64_t switch_checksum = 0, hsm_checksum = 0;
+		results.push_back(measure<SwitchMachine>(pattern + "/switch", deliveries, switch_checksum));
+		results.push_back(measure<Machine>(pattern + "/hsm", deliveries, hsm_checksum));
+		same = same && switch_checksum == hsm_checksum;
+	}
+	
+	Print({ { "elements", EVENTS }, { "repetitions", REPETITIONS } }, results);
+	if (!same)
+	{
+		std::fprintf(stderr, "The two machines disagree\n");
+		return 1;
+	}
+}
@@ -0,0 +1,140 @@
+/**
+ * Dispatch benchmark for the RunState generated by MAKE_STATE.hpp: the default switch, against the MAKE_STATE_TABLE
+ * function-pointer table, and its batch RunStates; and the default switch generated inside a class body.
+ * Build from the repository root with, e.g.
+ * 	g++ -std=c++20 -O2 -I. Benchmarks/MAKE_STATE_Benchmark.cpp -o MAKE_STATE_Benchmark
+ *
+ * The same 16 states are generated three times, once per mode, each with its own functions. ACTORS actors each hold a state,
+ * laid out in three patterns, from perfectly predictable to not at all:
+ * 	+ "constant": every actor is in the same state.
+ * 	+ "cyclic": states come round in order, 0, 1, ... 15, 0, ...
+ * 	+ "random": uniformly random states.
+ * Each pattern runs the states of all actors with:
+ * 	+ "switch": RunState on every actor in turn, default mode.
+ * 	+ "table": RunState on every actor in turn, MAKE_STATE_TABLE mode.
+ * 	+ "table/RunStates": a single RunStates call over all actors, which runs them grouped by state.
+ * 	+ "member": RunState on every actor in turn, default mode, generated as members of a class.
+ * Every state function folds its own constant into the actor it is given; all methods must leave every actor with the
+ * same value, and the benchmark fails otherwise.
+ * The results are written to stdout as a single JSON document, with one entry per (pattern, method), holding
+ * "ns_per_element": best of all repetitions, per actor.
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <span>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include "Benchmark.hpp"
+
+namespace {
+	
+	constexpr size_t ACTORS = size_t(1) << 16;
+	constexpr size_t REPETITIONS = 64;
+	
+	// What every actor is, to its states; each of them folds a different constant into it, so that none fold into another.
+	using Actor = uint32_t;
+	
+}
+
+#define STATES(v) v(S0) v(S1) v(S2) v(S3) v(S4) v(S5) v(S6) v(S7) v(S8) v(S9) v(S10) v(S11) v(S12) v(S13) v(S14) v(S15)
+
+namespace switch_mode {
+	
+	#define MAKE_STATE STATES
+	#define MAKE_STATE_PARAMETERS Actor& actor
+	#define MAKE_STATE_ARGUMENTS actor
+	#include "MAKE_STATE.hpp"
+	
+}
+
+namespace table_mode {
+	
+	#define MAKE_STATE STATES
+	#define MAKE_STATE_TABLE
+	#define MAKE_STATE_PARAMETERS Actor& actor
+	#define MAKE_STATE_ARGUMENTS actor
+	#include "MAKE_STATE.hpp"
+	
+}
+
+// Included in a class body, the state functions and RunState are member functions, and StateCount and States static members.
+struct member_mode
+{
+	#define MAKE_STATE STATES
+	#define MAKE_STATE_PARAMETERS Actor& actor
+	#define MAKE_STATE_ARGUMENTS actor
+	#include "MAKE_STATE.hpp"
+};
+static_assert(member_mode::StateCount == 16 && member_mode::States[15] == member_mode::State::S15);
+
+#define DEFINE_STATE(l) \
+	void switch_mode::l(Actor& actor) { actor = actor * 33 + uint32_t(__LINE__ + sizeof(#l)); } \
+	void table_mode::l(Actor& actor) { actor = actor * 33 + uint32_t(__LINE__ + sizeof(#l)); } \
+	void member_mode::l(Actor& actor) { actor = actor * 33 + uint32_t(__LINE__ + sizeof(#l)); }
+STATES(DEFINE_STATE)
+#undef DEFINE_STATE
+
+namespace {
+	
+	using namespace ink::benchmark;
+	
+	// Best time of run() over every repetition, each starting from fresh actors, left as the last one leaves them.
+	template<typename Run> Result
+	measure(std::string name, std::vector<Actor>& actors, Run&& run)
+	{
+		return Measure(std::move(name), ACTORS, REPETITIONS, [&]
+		{
+			actors.assign(ACTORS, 0);
+			const auto start = Clock::now();
+			run();
+			return Since(start);
+		});
+	}
+	
+}
+
+int
+main()
+{
+	constexpr size_t STATE_COUNT = 16;
+	std::mt19937_64 rng(ACTORS);
+	std::uniform_int_distribution<size_t> any(0, STATE_COUNT - 1);
+	
+	std::vector<Result> results;
+	
+	for (std::string pattern : { "constant", "cyclic", "random" })
+	{
+		std::vector<switch_mode::State> switch_states(ACTORS);
+		std::vector<table_mode::State> table_states(ACTORS);
+		std::vector<member_mode::State> member_states(ACTORS);
+		for (size_t i = 0; i < ACTORS; i++)
+		{
+			const size_t s = pattern == "constant" ? STATE_COUNT / 2 : pattern == "cyclic" ? i % STATE_COUNT : any(rng);
+			switch_states[i] = switch_mode::State(s);
+			table_states[i] = table_mode::State(s);
+			member_states[i] = member_mode::State(s);
+		}
+		
+		std::vector<Actor> switched, tabled, batched, membered;
+		results.push_back(measure(pattern + "/switch", switched, [&] { for (size_t i = 0; i < ACTORS; i++) switch_mode::RunState(switch_states[i], switched[i]); }));
+		results.push_back(measure(pattern + "/table", tabled, [&] { for (size_t i = 0; i < ACTORS; i++) table_mode::RunState(table_states[i], tabled[i]); }));
+		results.push_back(measure(pattern + "/table/RunStates", batched, [&] {
+			table_mode::RunStates(table_states, [&](size_t i) { return std::forward_as_tuple(batched[i]); });
+		}));
+		member_mode member;
+		results.push_back(measure(pattern + "/member", membered, [&] { for (size_t i = 0; i < ACTORS; i++) member.RunState(member_states[i], membered[i]); }));
+		
+		if (switched != tabled || switched != batched || switched != membered)
+		{
+			std::fprintf(stderr, "The methods disagree on the %s pattern\n", pattern.c_str());
+			return 1;
+		}
+	}
+	
+	Print({ { "elements", ACTORS }, { "repetitions", REPETITIONS } }, results);
+}
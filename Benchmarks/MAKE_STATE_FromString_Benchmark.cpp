@@ -0,0 +1,160 @@
+/**
+ * Lookup benchmark for the FromString generated by MAKE_STATE.hpp (MAKE_STATE_FROM_STRING), against a linear strcmp
+ * search of the MAKE_STATE_STRINGS names, and a std::unordered_map, for 10, 50, 100 and 500 states.
+ * Build from the repository root with, e.g.
+ * 	g++ -std=c++20 -O2 -I. Benchmarks/MAKE_STATE_FromString_Benchmark.cpp -o MAKE_STATE_FromString_Benchmark
+ * Building it also builds the perfect hash of all 500 names at compile time, and checks it with static_asserts.
+ *
+ * Each run looks up QUERIES names, picked at random, in one of two patterns:
+ * 	+ "hit": every name is one of the states.
+ * 	+ "miss": no name is, though each differs from one only by its last character.
+ * The results are written to stdout as a single JSON document, with one entry per (states, pattern, method), holding
+ * "ns_per_element": best of all repetitions, per lookup.
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <optional>
+#include <random>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include "Benchmark.hpp"
+#include "PerfectHash.hpp"
+
+// Fruit lists of 10, 100 and 500 names, all sharing the given prefix.
+#define NAMES_10(v, p) v(p##0) v(p##1) v(p##2) v(p##3) v(p##4) v(p##5) v(p##6) v(p##7) v(p##8) v(p##9)
+#define NAMES_100(v, p) NAMES_10(v, p##0) NAMES_10(v, p##1) NAMES_10(v, p##2) NAMES_10(v, p##3) NAMES_10(v, p##4) \
+	NAMES_10(v, p##5) NAMES_10(v, p##6) NAMES_10(v, p##7) NAMES_10(v, p##8) NAMES_10(v, p##9)
+
+namespace states_10 {
+	
+	#define MAKE_STATE(v) NAMES_10(v, Patrol_)
+	#define MAKE_STATE_STRINGS Name
+	#define MAKE_STATE_FROM_STRING FromString
+	#include "MAKE_STATE.hpp"
+	
+}
+
+namespace states_50 {
+	
+	#define MAKE_STATE(v) NAMES_10(v, Patrol_0) NAMES_10(v, Patrol_1) NAMES_10(v, Patrol_2) NAMES_10(v, Patrol_3) NAMES_10(v, Patrol_4)
+	#define MAKE_STATE_STRINGS Name
+	#define MAKE_STATE_FROM_STRING FromString
+	#include "MAKE_STATE.hpp"
+	
+}
+
+namespace states_100 {
+	
+	#define MAKE_STATE(v) NAMES_100(v, Patrol_)
+	#define MAKE_STATE_STRINGS Name
+	#define MAKE_STATE_FROM_STRING FromString
+	#include "MAKE_STATE.hpp"
+	
+}
+
+namespace states_500 {
+	
+	#define MAKE_STATE(v) NAMES_100(v, Patrol_0) NAMES_100(v, Patrol_1) NAMES_100(v, Patrol_2) NAMES_100(v, Patrol_3) NAMES_100(v, Patrol_4)
+	#define MAKE_STATE_STRINGS Name
+	#define MAKE_STATE_FROM_STRING FromString
+	#include "MAKE_STATE.hpp"
+	
+}
+
+// Declared by MAKE_STATE.hpp, unused here.
+#define DEFINE_STATE(l) void l() {}
+namespace states_10 { NAMES_10(DEFINE_STATE, Patrol_) }
+namespace states_50 { NAMES_10(DEFINE_STATE, Patrol_0) NAMES_10(DEFINE_STATE, Patrol_1) NAMES_10(DEFINE_STATE, Patrol_2) NAMES_10(DEFINE_STATE, Patrol_3) NAMES_10(DEFINE_STATE, Patrol_4) }
+namespace states_100 { NAMES_100(DEFINE_STATE, Patrol_) }
+namespace states_500 { NAMES_100(DEFINE_STATE, Patrol_0) NAMES_100(DEFINE_STATE, Patrol_1) NAMES_100(DEFINE_STATE, Patrol_2) NAMES_100(DEFINE_STATE, Patrol_3) NAMES_100(DEFINE_STATE, Patrol_4) }
+#undef DEFINE_STATE
+
+static_assert(states_500::StateCount == 500);
+static_assert(states_500::States[499] == states_500::State::Patrol_499);
+
+namespace {
+	
+	constexpr size_t QUERIES = size_t(1) << 16;
+	constexpr size_t REPETITIONS = 32;
+	
+	using namespace ink::benchmark;
+	
+	// Every state of every size, reflected.
+	static_assert(states_10::StateCount == 10 && states_50::StateCount == 50 && states_100::StateCount == 100);
+	
+	template<typename Lookup> Result
+	measure(std::string name, std::vector<std::string> const& queries, Lookup&& lookup)
+	{
+		return Measure(std::move(name), queries.size(), REPETITIONS, [&]
+		{
+			size_t sum = 0;
+			for (auto const& q : queries) sum += lookup(q);
+			
+			// Keep the optimizer from discarding the lookups.
+			volatile size_t sink = sum; (void)sink;
+		});
+	}
+	
+	// Every pattern over one set of states, given as their list, and the Name and FromString generated for them.
+	template<typename State, size_t N, typename Names, typename FromString> void
+	run(std::vector<Result>& results, std::span<const State, N> states, Names&& name, FromString&& from_string)
+	{
+		// The names, gathered once, as a hand-written table would hold them.
+		std::vector<char const*> names;
+		for (State s : states) names.push_back(name(s));
+		
+		std::unordered_map<std::string_view, State> map;
+		for (State s : states) map.emplace(name(s), s);
+		
+		std::mt19937_64 rng(N);
+		std::uniform_int_distribution<size_t> any(0, N - 1);
+		
+		for (std::string pattern : { "hit", "miss" })
+		{
+			std::vector<std::string> queries(QUERIES);
+			for (auto& q : queries)
+			{
+				q = name(states[any(rng)]);
+				if (pattern == "miss") q.back() = 'x';
+			}
+			
+			const auto prefix = "states=" + std::to_string(N) + "/" + pattern + "/";
+			
+			// Result: 1 + the state's value, 0 if none.
+			results.push_back(measure(prefix + "linear", queries, [&](std::string const& q) -> size_t {
+				for (size_t s = 0; s < N; s++) if (std::strcmp(names[s], q.c_str()) == 0) return s + 1;
+				return 0;
+			}));
+			
+			results.push_back(measure(prefix + "unordered_map", queries, [&](std::string const& q) -> size_t {
+				const auto found = map.find(q);
+				return found == map.end() ? 0 : size_t(found->second) + 1;
+			}));
+			
+			results.push_back(measure(prefix + "FromString", queries, [&](std::string const& q) -> size_t {
+				const auto found = from_string(q);
+				return found ? size_t(*found) + 1 : 0;
+			}));
+		}
+	}
+	
+}
+
+int
+main()
+{
+	std::vector<Result> results;
+	
+	run(results, std::span(states_10::States), states_10::Name, states_10::FromString);
+	run(results, std::span(states_50::States), states_50::Name, states_50::FromString);
+	run(results, std::span(states_100::States), states_100::Name, states_100::FromString);
+	run(results, std::span(states_500::States), states_500::Name, states_500::FromString);
+	
+	Print({ { "elements", QUERIES }, { "repetitions", REPETITIONS } }, results);
+}
@@ -0,0 +1,114 @@
+/**
+ * Overhead benchmark for MAKE_STATE_TRACE: RunState without tracing, against RunState recording every call through
+ * ink::StateTrace, and the cost of dumping and converting what was recorded.
+ * Build from the repository root with, e.g.
+ * 	g++ -std=c++20 -O2 -pthread -I. Benchmarks/MAKE_STATE_Trace_Benchmark.cpp -o MAKE_STATE_Trace_Benchmark
+ *
+ * The same 16 states are generated twice, once per mode, each with its own functions, and run over ACTORS actors in
+ * random states:
+ * 	+ "untraced": RunState, default mode.
+ * 	+ "traced": RunState, MAKE_STATE_TRACE mode.
+ * 	+ "traced/RunState_Untraced": the dispatch underneath the traced RunState, called directly.
+ * Then the traced events are written with Dump(), and converted with ToChromeTrace(), into the temporary directory.
+ * The results are written to stdout as a single JSON document, with one entry per method, holding "ns_per_element":
+ * best of all repetitions, per call (per event written, for "dump" and "convert").
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <random>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "Benchmark.hpp"
+#include "StateTrace.hpp"
+
+namespace {
+	
+	constexpr size_t ACTORS = size_t(1) << 16;
+	constexpr size_t REPETITIONS = 64;
+	
+	// Every state function folds a different constant into this, so that none of them fold into another.
+	uint32_t accumulator = 0;
+	
+}
+
+#define STATES(v) v(S0) v(S1) v(S2) v(S3) v(S4) v(S5) v(S6) v(S7) v(S8) v(S9) v(S10) v(S11) v(S12) v(S13) v(S14) v(S15)
+
+namespace untraced {
+	
+	#define MAKE_STATE STATES
+	#include "MAKE_STATE.hpp"
+	
+}
+
+namespace traced {
+	
+	#define MAKE_STATE STATES
+	#define MAKE_STATE_TRACE
+	#include "MAKE_STATE.hpp"
+	
+}
+
+#define DEFINE_STATE(l) \
+	void untraced::l() { accumulator = accumulator * 33 + uint32_t(__LINE__ + sizeof(#l)); } \
+	void traced::l() { accumulator = accumulator * 33 + uint32_t(__LINE__ + sizeof(#l)); }
+STATES(DEFINE_STATE)
+#undef DEFINE_STATE
+
+namespace {
+	
+	using namespace ink::benchmark;
+	
+	template<typename Run> Result
+	measure(std::string name, size_t elements, size_t repetitions, Run&& run)
+	{
+		return Measure(std::move(name), elements, repetitions, [&]
+		{
+			accumulator = 0;
+			const auto start = Clock::now();
+			run();
+			const double elapsed = Since(start);
+			
+			// Keep the optimizer from discarding the calls.
+			volatile uint32_t sink = accumulator; (void)sink;
+			return elapsed;
+		});
+	}
+	
+}
+
+int
+main()
+{
+	constexpr size_t STATE_COUNT = 16;
+	std::mt19937_64 rng(ACTORS);
+	std::uniform_int_distribution<size_t> any(0, STATE_COUNT - 1);
+	
+	std::vector<untraced::State> untraced_states(ACTORS);
+	std::vector<traced::State> traced_states(ACTORS);
+	for (size_t i = 0; i < ACTORS; i++)
+	{
+		const size_t s = any(rng);
+		untraced_states[i] = untraced::State(s);
+		traced_states[i] = traced::State(s);
+	}
+	
+	std::vector<Result> results;
+	results.push_back(measure("untraced", ACTORS, REPETITIONS, [&] { for (auto s : untraced_states) untraced::RunState(s); }));
+	results.push_back(measure("traced", ACTORS, REPETITIONS, [&] { for (auto s : traced_states) traced::RunState(s); }));
+	results.push_back(measure("traced/RunState_Untraced", ACTORS, REPETITIONS, [&] { for (auto s : traced_states) traced::RunState_Untraced(s); }));
+	
+	const std::filesystem::path directory = std::filesystem::temp_directory_path();
+	const std::string binary = (directory / "MAKE_STATE_Trace_Benchmark.trace").string();
+	const std::string json = (directory / "MAKE_STATE_Trace_Benchmark.json").string();
+	
+	size_t events = 0;
+	results.push_back(measure("dump", INK_STATE_TRACE_RING, 8, [&] { events = ink::StateTrace::Dump(binary); }));
+	results.push_back(measure("convert", INK_STATE_TRACE_RING, 8, [&] { ink::StateTrace::ToChromeTrace(binary, json); }));
+	
+	Print({ { "elements", ACTORS }, { "repetitions", REPETITIONS }, { "events", events } }, results);
+}
@@ -0,0 +1,108 @@
+/**
+ * 3D stencil benchmark for ink::Indexing::mdview, against the lambda-based TransposeToAbsolute/TransposeFromAbsolute.
+ * Build from the repository root with, e.g.
+ * 	g++ -std=c++20 -O2 -I. Benchmarks/MDView_Benchmark.cpp -o MDView_Benchmark
+ *
+ * Two sweeps over a SIZE^3 grid of floats, each run through every indexing scheme:
+ * 	+ "stencil": a 7-point stencil over the interior, addressing all 7 cells by coordinates.
+ * 	+ "coordinates": a walk over every flat index, turning each back into coordinates.
+ * The results are written to stdout as a single JSON document, with one entry per (sweep, scheme), holding
+ * "ns_per_element": best of all repetitions.
+ */
+
+#include <cstdio>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "Benchmark.hpp"
+#include "MDView.hpp"
+#include "MultiArrayIndexing.hpp"
+
+namespace {
+	
+	constexpr size_t SIZE = 128;
+	constexpr size_t ELEMENTS = SIZE * SIZE * SIZE;
+	constexpr size_t REPETITIONS = 16;
+	
+	using namespace ink::Indexing;
+	using namespace ink::benchmark;
+	
+	template<typename Sweep> Result
+	measure(std::string name, Sweep&& sweep)
+	{
+		return Measure(std::move(name), ELEMENTS, REPETITIONS, [&]
+		{
+			// Keep the optimizer from discarding the sweep.
+			volatile double sink = sweep(); (void)sink;
+		});
+	}
+	
+	/**
+	 * out = in + the sum of its six neighbours, over the interior; at(z, y, x) gives the offset of a cell.
+	 */
+	template<typename At> double
+	stencil(std::vector<float> const& in, std::vector<float>& out, At&& at)
+	{
+		for (size_t z = 1; z + 1 < SIZE; z++)
+		for (size_t y = 1; y + 1 < SIZE; y++)
+		for (size_t x = 1; x + 1 < SIZE; x++)
+		{
+			out[at(z, y, x)] = in[at(z, y, x)]
+				+ in[at(z - 1, y, x)] + in[at(z + 1, y, x)]
+				+ in[at(z, y - 1, x)] + in[at(z, y + 1, x)]
+				+ in[at(z, y, x - 1)] + in[at(z, y, x + 1)];
+		}
+		return out[at(SIZE / 2, SIZE / 2, SIZE / 2)];
+	}
+	
+}
+
+int
+main()
+{
+	std::vector<float> in(ELEMENTS), out(ELEMENTS);
+	for (size_t i = 0; i < ELEMENTS; i++) in[i] = float(i % 97);
+	
+	// Runtime sizes, so that the dynamic schemes really are dynamic.
+	volatile size_t runtime_size = SIZE;
+	const size_t n = runtime_size;
+	
+	const auto absolute = TransposeToAbsolute(n, n, n);
+	const mdview<float const, SIZE, SIZE, SIZE> fixed(in.data());
+	const mdview<float const, dynamic_extent, dynamic_extent, dynamic_extent> dynamic(in.data(), n, n, n);
+	
+	std::vector<Result> results;
+	
+	results.push_back(measure("stencil/TransposeToAbsolute", [&]
+	{ return stencil(in, out, [&](size_t z, size_t y, size_t x) { return absolute(x, y, z); }); }));
+	
+	results.push_back(measure("stencil/mdview[static]", [&]
+	{ return stencil(in, out, [&](size_t z, size_t y, size_t x) { return fixed.offset(z, y, x); }); }));
+	
+	results.push_back(measure("stencil/mdview[dynamic]", [&]
+	{ return stencil(in, out, [&](size_t z, size_t y, size_t x) { return dynamic.offset(z, y, x); }); }));
+	
+	results.push_back(measure("coordinates/TransposeFromAbsolute", [&]
+	{
+		size_t sum = 0;
+		for (size_t i = 0; i < ELEMENTS; i++) { auto [x, y, z] = TransposeFromAbsolute<SIZE, SIZE, SIZE>(i); sum += x ^ y ^ z; }
+		return double(sum);
+	}));
+	
+	results.push_back(measure("coordinates/mdview[static]", [&]
+	{
+		size_t sum = 0;
+		for (size_t i = 0; i < ELEMENTS; i++) { auto [z, y, x] = fixed.coordinates(i); sum += x ^ y ^ z; }
+		return double(sum);
+	}));
+	
+	results.push_back(measure("coordinates/mdview[dynamic]", [&]
+	{
+		size_t sum = 0;
+		for (size_t i = 0; i < ELEMENTS; i++) { auto [z, y, x] = dynamic.coordinates(i); sum += x ^ y ^ z; }
+		return double(sum);
+	}));
+	
+	Print({ { "elements", ELEMENTS }, { "repetitions", REPETITIONS } }, results);
+}
@@ -0,0 +1,151 @@
+/**
+ * Locality benchmark for the ink::Indexing layouts: row-major (TransposeToAbsolute), tiled (TransposeToTiled) and Morton
+ * (TransposeToMorton), over a SIZE x SIZE grid of floats.
+ * Build from the repository root with, e.g.
+ * 	g++ -std=c++20 -O2 -I. Benchmarks/MultiArrayIndexing_Benchmark.cpp -o MultiArrayIndexing_Benchmark
+ * and again with -mbmi2 added, to compare the pdep/pext Morton path against the portable one.
+ *
+ * Every layout runs the same sweeps, each going through its own mapping for every cell:
+ * 	+ "neighborhood": sums the RADIUS box around each of a list of random cells.
+ * 	+ "column_walk": sums the grid column by column, the walk row-major storage is worst at.
+ * 	+ "transpose": writes the transpose of one grid into another, in the same layout.
+ * 	+ "decode": turns every absolute index back into coordinates.
+ * Then, over a WALK^3 grid, "walk" visits every cell with both its absolute index and its coordinates: once by calling
+ * TransposeFromAbsolute on each absolute index, once with Cells(), and once with Cells() cut into CHUNKS slices.
+ * The results are written to stdout as a single JSON document, with one entry per (sweep, layout), holding
+ * "ns_per_element": best of all repetitions, per cell touched.
+ */
+
+#include <cstdio>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "Benchmark.hpp"
+#include "MultiArrayIndexing.hpp"
+
+namespace {
+	
+	constexpr size_t SIZE = 2048;
+	constexpr size_t ELEMENTS = SIZE * SIZE;
+	constexpr size_t REPETITIONS = 8;
+	constexpr size_t CENTERS = size_t(1) << 16;
+	constexpr size_t RADIUS = 2;
+	constexpr size_t TILE = 8;
+	constexpr size_t WALK = 100;
+	constexpr size_t CHUNKS = 64;
+	
+	using namespace ink::Indexing;
+	using namespace ink::benchmark;
+	
+	template<typename Sweep> Result
+	measure(std::string name, size_t touched, Sweep&& sweep)
+	{
+		return Measure(std::move(name), touched, REPETITIONS, [&]
+		{
+			// Keep the optimizer from discarding the sweep.
+			volatile double sink = sweep(); (void)sink;
+		});
+	}
+	
+	/**
+	 * Runs every sweep over one layout; to(x, y) maps coordinates to an absolute index, and from(i) maps back.
+	 */
+	template<typename To, typename From> void
+	run(std::vector<Result>& results, std::string const& layout, To&& to, From&& from, std::vector<std::pair<size_t, size_t>> const& centers)
+	{
+		std::vector<float> in(ELEMENTS), out(ELEMENTS);
+		for (size_t y = 0; y < SIZE; y++) for (size_t x = 0; x < SIZE; x++) in[to(x, y)] = float((x * 7 + y * 13) % 101);
+		
+		constexpr size_t BOX = (2 * RADIUS + 1) * (2 * RADIUS + 1);
+		results.push_back(measure("neighborhood/" + layout, CENTERS * BOX, [&]
+		{
+			double sum = 0;
+			for (auto [cx, cy] : centers)
+			for (size_t y = cy - RADIUS; y <= cy + RADIUS; y++)
+			for (size_t x = cx - RADIUS; x <= cx + RADIUS; x++)
+			{ sum += in[to(x, y)]; }
+			return sum;
+		}));
+		
+		results.push_back(measure("column_walk/" + layout, ELEMENTS, [&]
+		{
+			double sum = 0;
+			for (size_t x = 0; x < SIZE; x++) for (size_t y = 0; y < SIZE; y++) sum += in[to(x, y)];
+			return sum;
+		}));
+		
+		results.push_back(measure("transpose/" + layout, ELEMENTS, [&]
+		{
+			for (size_t y = 0; y < SIZE; y++) for (size_t x = 0; x < SIZE; x++) out[to(y, x)] = in[to(x, y)];
+			return double(out[to(1, 2)]);
+		}));
+		
+		results.push_back(measure("decode/" + layout, ELEMENTS, [&]
+		{
+			size_t sum = 0;
+			for (size_t i = 0; i < ELEMENTS; i++) { auto [x, y] = from(i); sum += x ^ y; }
+			return double(sum);
+		}));
+	}
+	
+	void
+	walk(std::vector<Result>& results)
+	{
+		constexpr size_t CELLS = WALK * WALK * WALK;
+		
+		results.push_back(measure("walk/TransposeFromAbsolute", CELLS, []
+		{
+			size_t sum = 0;
+			for (size_t i = 0; i < CELLS; i++) { auto [x, y, z] = TransposeFromAbsolute<WALK, WALK, WALK>(i); sum += i ^ x ^ y ^ z; }
+			return double(sum);
+		}));
+		
+		results.push_back(measure("walk/Cells", CELLS, []
+		{
+			size_t sum = 0;
+			for (auto const& [i, xyz] : Cells(WALK, WALK, WALK)) sum += i ^ xyz[0] ^ xyz[1] ^ xyz[2];
+			return double(sum);
+		}));
+		
+		results.push_back(measure("walk/Cells[chunked]", CELLS, []
+		{
+			const auto cells = Cells(WALK, WALK, WALK);
+			size_t sum = 0;
+			for (size_t c = 0; c < CHUNKS; c++) for (auto const& [i, xyz] : cells.chunk(c, CHUNKS)) sum += i ^ xyz[0] ^ xyz[1] ^ xyz[2];
+			return double(sum);
+		}));
+	}
+	
+}
+
+int
+main()
+{
+	std::mt19937_64 rng(SIZE);
+	std::uniform_int_distribution<size_t> any(RADIUS, SIZE - 1 - RADIUS);
+	std::vector<std::pair<size_t, size_t>> centers(CENTERS);
+	for (auto& c : centers) c = { any(rng), any(rng) };
+	
+	std::vector<Result> results;
+	
+	run(results, "row_major",
+		TransposeToAbsolute(SIZE, SIZE),
+		[](size_t i) { return TransposeFromAbsolute<SIZE, SIZE>(i); },
+		centers);
+	
+	run(results, "tiled",
+		TransposeToTiled<TILE, TILE>(SIZE, SIZE),
+		TransposeFromTiled<TILE, TILE>(SIZE, SIZE),
+		centers);
+	
+	run(results, "morton",
+		[](size_t x, size_t y) { return TransposeToMorton(x, y); },
+		[](size_t i) { return TransposeFromMorton<2>(i); },
+		centers);
+	
+	walk(results);
+	
+	Print({ { "elements", ELEMENTS }, { "repetitions", REPETITIONS } }, results);
+}
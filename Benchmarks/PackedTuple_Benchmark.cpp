@@ -0,0 +1,104 @@
+/**
+ * Size/throughput report for ink::packed_tuple, against std::tuple over the same component lists.
+ * Build from the repository root with, e.g.
+ * 	g++ -std=c++20 -O2 -I. Benchmarks/PackedTuple_Benchmark.cpp -o PackedTuple_Benchmark
+ *
+ * Each list is laid out both ways, and a vector of ELEMENTS rows of each is swept, reading a few members per row.
+ * The results are written to stdout as a single JSON document, with one entry per list, holding:
+ * 	+ "std_tuple_bytes" and "packed_tuple_bytes": sizeof a row.
+ * 	+ "std_tuple_ns" and "packed_tuple_ns": nanoseconds per row of the sweep, best of all repetitions.
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <tuple>
+#include <vector>
+
+#include "Benchmark.hpp"
+#include "PackedTuple.hpp"
+
+namespace {
+	
+	constexpr size_t ELEMENTS = size_t(1) << 20;
+	constexpr size_t REPETITIONS = 32;
+	
+	using ink::rebind::type_list;
+	
+	// Typical component lists, in the order they tend to get declared: grouped by meaning rather than by size.
+	using Particle = type_list<bool, double, char, float, double, short>;
+	using Transform = type_list<uint8_t, float, float, float, uint16_t, double, bool, float>;
+	using Body = type_list<uint32_t, bool, double, double, uint8_t, double, float, bool, uint16_t, double>;
+	using Agent = type_list<bool, uint64_t, uint8_t, uint32_t, bool, double, uint16_t, float, uint8_t, uint64_t, bool, float>;
+	
+	struct Result
+	{
+		const char* name;
+		size_t std_tuple_bytes = 0;
+		size_t packed_tuple_bytes = 0;
+		double std_tuple_ns = 0;
+		double packed_tuple_ns = 0;
+	};
+	
+	/**
+	 * Sums the first, the last and one middle member of every row, best of REPETITIONS; returns nanoseconds per row.
+	 */
+	template<typename Row> double
+	sweep()
+	{
+		constexpr size_t LAST = std::tuple_size_v<Row> - 1, MIDDLE = LAST / 2;
+		
+		std::vector<Row> rows(ELEMENTS);
+		for (size_t i = 0; i < rows.size(); i++)
+		{
+			using std::get;
+			get<0>(rows[i]) = static_cast<std::tuple_element_t<0, Row>>(i & 1);
+			get<MIDDLE>(rows[i]) = static_cast<std::tuple_element_t<MIDDLE, Row>>(i % 7);
+			get<LAST>(rows[i]) = static_cast<std::tuple_element_t<LAST, Row>>(i % 3);
+		}
+		
+		return ink::benchmark::Best(REPETITIONS, [&]
+		{
+			double sum = 0;
+			for (auto const& row : rows)
+			{
+				using std::get;
+				sum += double(get<0>(row)) + double(get<MIDDLE>(row)) + double(get<LAST>(row));
+			}
+			
+			// Keep the optimizer from discarding the sweep.
+			volatile double sink = sum; (void)sink;
+		}) / double(ELEMENTS);
+	}
+	
+	template<typename List> Result
+	measure(const char* name)
+	{
+		using Tuple = typename List::template unpack_into<std::tuple>;
+		using Packed = typename List::template unpack_into<ink::packed_tuple>;
+		
+		Result result{ name };
+		result.std_tuple_bytes = sizeof(Tuple);
+		result.packed_tuple_bytes = sizeof(Packed);
+		result.std_tuple_ns = sweep<Tuple>();
+		result.packed_tuple_ns = sweep<Packed>();
+		return result;
+	}
+	
+}
+
+int
+main()
+{
+	std::vector<Result> results;
+	
+	results.push_back(measure<Particle>("Particle"));
+	results.push_back(measure<Transform>("Transform"));
+	results.push_back(measure<Body>("Body"));
+	results.push_back(measure<Agent>("Agent"));
+	
+	ink::benchmark::Print({ { "elements", ELEMENTS }, { "repetitions", REPETITIONS } }, results, [](Result const& res)
+	{
+		std::printf("\"name\": \"%s\", \"std_tuple_bytes\": %zu, \"packed_tuple_bytes\": %zu, \"std_tuple_ns\": %.4f, \"packed_tuple_ns\": %.4f",
+			res.name, res.std_tuple_bytes, res.packed_tuple_bytes, res.std_tuple_ns, res.packed_tuple_ns);
+	});
+}
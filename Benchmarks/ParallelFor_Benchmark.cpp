@@ -0,0 +1,106 @@
+/**
+ * Scaling benchmark for ink::Indexing::parallel_for, on a 7-point 3D stencil over a SIZE^3 grid of floats.
+ * Build from the repository root with, e.g.
+ * 	g++ -std=c++20 -O2 -pthread -I. Benchmarks/ParallelFor_Benchmark.cpp -o ParallelFor_Benchmark
+ * and run as | ParallelFor_Benchmark [max_threads] |; max_threads defaults to std::thread::hardware_concurrency().
+ *
+ * Every thread count from 1 to max_threads runs the stencil two ways:
+ * 	+ "manual": the flat index range cut by hand into one equal slice per thread, each on a freshly started std::thread,
+ * 	  every index mapped back to coordinates with TransposeFromAbsolute.
+ * 	+ "parallel_for": parallel_for over the interior, on a ThreadPool of that many threads, started once beforehand.
+ * The results are written to stdout as a single JSON document, with one entry per (method, threads), holding
+ * "ns_per_element": best of all repetitions, per interior cell, and "speedup": against the same method on one thread.
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include "Benchmark.hpp"
+#include "ParallelFor.hpp"
+
+namespace {
+	
+	constexpr size_t SIZE = 192;
+	constexpr size_t ELEMENTS = SIZE * SIZE * SIZE;
+	constexpr size_t INTERIOR = (SIZE - 2) * (SIZE - 2) * (SIZE - 2);
+	constexpr size_t REPETITIONS = 8;
+	
+	using namespace ink::Indexing;
+	
+	struct Result
+	{
+		std::string name;
+		size_t threads = 0;
+		double ns_per_element = 0;
+		double speedup = 0;
+	};
+	
+	template<typename Sweep> double
+	measure(Sweep&& sweep)
+	{ return ink::benchmark::Best(REPETITIONS, std::forward<Sweep>(sweep)) / double(INTERIOR); }
+	
+	// out = in + the sum of its six neighbours, at one interior cell.
+	inline void
+	stencil(std::vector<float> const& in, std::vector<float>& out, size_t x, size_t y, size_t z)
+	{
+		constexpr auto at = TransposeToAbsolute(SIZE, SIZE, SIZE);
+		out[at(x, y, z)] = in[at(x, y, z)]
+			+ in[at(x - 1, y, z)] + in[at(x + 1, y, z)]
+			+ in[at(x, y - 1, z)] + in[at(x, y + 1, z)]
+			+ in[at(x, y, z - 1)] + in[at(x, y, z + 1)];
+	}
+	
+}
+
+int
+main(int argc, char** argv)
+{
+	const size_t max_threads = argc > 1 ? std::max(std::strtoul(argv[1], nullptr, 10), 1ul) : std::max(std::thread::hardware_concurrency(), 1u);
+	
+	std::vector<float> in(ELEMENTS), out(ELEMENTS);
+	for (size_t i = 0; i < ELEMENTS; i++) in[i] = float(i % 97);
+	
+	std::vector<Result> results;
+	double manual_one = 0, parallel_one = 0;
+	
+	for (size_t threads = 1; threads <= max_threads; threads++)
+	{
+		const double manual = measure([&]
+		{
+			std::vector<std::thread> workers;
+			for (size_t t = 0; t < threads; t++) workers.emplace_back([&, t]
+			{
+				for (size_t i = ELEMENTS * t / threads; i < ELEMENTS * (t + 1) / threads; i++)
+				{
+					auto [x, y, z] = TransposeFromAbsolute<SIZE, SIZE, SIZE>(i);
+					if (x - 1 < SIZE - 2 && y - 1 < SIZE - 2 && z - 1 < SIZE - 2) stencil(in, out, x, y, z);
+				}
+			});
+			for (auto& worker : workers) worker.join();
+		});
+		
+		ink::ThreadPool pool(threads);
+		const double parallel = measure([&]
+		{
+			parallel_for(pool, { SIZE - 2, SIZE - 2, SIZE - 2 }, [&](size_t x, size_t y, size_t z) { stencil(in, out, x + 1, y + 1, z + 1); });
+		});
+		
+		if (threads == 1) { manual_one = manual; parallel_one = parallel; }
+		results.push_back({ "manual", threads, manual, manual_one / manual });
+		results.push_back({ "parallel_for", threads, parallel, parallel_one / parallel });
+	}
+	
+	// Keep the optimizer from discarding the sweeps.
+	volatile float sink = out[ELEMENTS / 2]; (void)sink;
+	
+	ink::benchmark::Print({ { "elements", INTERIOR }, { "repetitions", REPETITIONS } }, results, [](Result const& result)
+	{
+		std::printf("\"name\": \"%s\", \"threads\": %zu, \"ns_per_element\": %.4f, \"speedup\": %.2f",
+			result.name.c_str(), result.threads, result.ns_per_element, result.speedup);
+	});
+}
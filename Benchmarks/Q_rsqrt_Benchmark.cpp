@@ -0,0 +1,203 @@
+/**
+ * Accuracy/throughput benchmark for ink::Q_rsqrt, against the standard library and the hardware reciprocal square root.
+ * Build from the repository root with, e.g.
+ * 	g++ -std=c++20 -O2 -I. Benchmarks/Q_rsqrt_Benchmark.cpp -o Q_rsqrt_Benchmark
+ *
+ * Every variant is run over the same log-uniformly distributed inputs. The results are written to stdout as a single
+ * JSON document, with one entry per variant, holding:
+ * 	+ "ns_per_element": best of all repetitions.
+ * 	+ "max_rel_error" and "mean_rel_error": relative to a long double 1/sqrt.
+ * 	+ "ulp_histogram": counts of ULP distances to the correctly rounded result, in buckets [0], [1], [2,3], [4,7], ... [2^k, inf).
+ */
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Benchmark.hpp"
+#include "Vector2Array.hpp"
+
+namespace {
+	
+	constexpr size_t ELEMENTS = size_t(1) << 16;
+	constexpr size_t REPETITIONS = 64;
+	constexpr size_t ULP_BUCKETS = 24;
+	
+	struct Result : ink::benchmark::Result
+	{
+		double max_rel_error = 0;
+		double mean_rel_error = 0;
+		uint64_t ulp_histogram[ULP_BUCKETS] = {};
+	};
+	
+	// Bucket 0 holds exact results, bucket k holds distances in [2^(k-1), 2^k), and the last bucket holds everything beyond.
+	size_t
+	ulp_bucket(uint64_t ulps)
+	{ return std::min<size_t>(std::bit_width(ulps), ULP_BUCKETS - 1); }
+	
+	template<typename T> uint64_t
+	ulp_distance(T a, T b)
+	{
+		using bits = std::conditional_t<sizeof(T) == 4, uint32_t, uint64_t>;
+		if (std::isnan(a) || std::isnan(b)) return ~uint64_t(0);
+		
+		// Map the sign-magnitude representation onto a monotonic unsigned line.
+		auto ordered = [](T v)
+		{
+			const bits b = std::bit_cast<bits>(v);
+			constexpr bits SIGN = bits(1) << (sizeof(bits) * 8 - 1);
+			return (b & SIGN) ? bits(~b) : bits(b | SIGN);
+		};
+		const bits oa = ordered(a), ob = ordered(b);
+		return oa > ob ? oa - ob : ob - oa;
+	}
+	
+	/**
+	 * Times kernel(in, out, n) and compares out against a long double reference.
+	 */
+	template<typename T, typename Kernel> Result
+	measure(std::string name, std::vector<T> const& in, Kernel&& kernel)
+	{
+		std::vector<T> out(in.size());
+		Result result{ ink::benchmark::Measure(std::move(name), in.size(), REPETITIONS, [&]
+		{
+			kernel(in.data(), out.data(), in.size());
+			
+			// Keep the optimizer from discarding the output between repetitions.
+			volatile T sink = out[out.size() / 2]; (void)sink;
+		}) };
+		
+		double sum = 0;
+		for (size_t i = 0; i < in.size(); i++)
+		{
+			const long double exact = 1.0L / std::sqrt(static_cast<long double>(in[i]));
+			const double rel = static_cast<double>(std::fabs((static_cast<long double>(out[i]) - exact) / exact));
+			
+			result.max_rel_error = std::max(result.max_rel_error, rel);
+			sum += rel;
+			result.ulp_histogram[ulp_bucket(ulp_distance(out[i], static_cast<T>(exact)))]++;
+		}
+		result.mean_rel_error = sum / double(in.size());
+		
+		return result;
+	}
+	
+	template<typename T> std::vector<T>
+	make_inputs()
+	{
+		std::mt19937_64 rng(0x5f3759df);
+		std::uniform_real_distribution<double> exponent(-6.0, 6.0);
+		
+		std::vector<T> in(ELEMENTS);
+		for (auto& v : in) v = static_cast<T>(std::pow(10.0, exponent(rng)));
+		return in;
+	}
+	
+	#if defined(INK_VECTOR2_ARRAY_X86)
+	
+	INK_VECTOR2_ARRAY_TARGET("sse") void
+	hw_rsqrt(float const* in, float* out, size_t n)
+	{
+		size_t i = 0;
+		for (; i + 4 <= n; i += 4) _mm_storeu_ps(out + i, _mm_rsqrt_ps(_mm_loadu_ps(in + i)));
+		for (; i < n; i++) _mm_store_ss(out + i, _mm_rsqrt_ss(_mm_load_ss(in + i)));
+	}
+	
+	// _mm_rsqrt_ps refined with one Newton-Raphson step; y' = y * (1.5 - 0.5 * x * y * y)
+	INK_VECTOR2_ARRAY_TARGET("sse") void
+	hw_rsqrt_newton(float const* in, float* out, size_t n)
+	{
+		const __m128 HALF = _mm_set1_ps(0.5F), THREE_HALVES = _mm_set1_ps(1.5F);
+		
+		size_t i = 0;
+		for (; i + 4 <= n; i += 4)
+		{
+			const __m128 x = _mm_loadu_ps(in + i);
+			const __m128 y = _mm_rsqrt_ps(x);
+			_mm_storeu_ps(out + i, _mm_mul_ps(y, _mm_sub_ps(THREE_HALVES, _mm_mul_ps(_mm_mul_ps(_mm_mul_ps(x, HALF), y), y))));
+		}
+		for (; i < n; i++)
+		{
+			const float y = _mm_cvtss_f32(_mm_rsqrt_ss(_mm_load_ss(in + i)));
+			out[i] = y * (1.5F - (in[i] * 0.5F * y * y));
+		}
+	}
+	
+	// The 512-bit form only needs AVX-512F, where _mm_rsqrt14_ps would also need AVX-512VL; the approximation is identical.
+	// Zero-masked forms are used throughout, as the unmasked one trips -Wmaybe-uninitialized on GCC.
+	INK_VECTOR2_ARRAY_TARGET("avx512f") void
+	hw_rsqrt14(float const* in, float* out, size_t n)
+	{
+		const __mmask16 ALL = __mmask16(~0);
+		
+		size_t i = 0;
+		for (; i + 16 <= n; i += 16) _mm512_storeu_ps(out + i, _mm512_maskz_rsqrt14_ps(ALL, _mm512_loadu_ps(in + i)));
+		
+		const __mmask16 tail = __mmask16((1u << (n - i)) - 1);
+		_mm512_mask_storeu_ps(out + i, tail, _mm512_maskz_rsqrt14_ps(tail, _mm512_maskz_loadu_ps(tail, in + i)));
+	}
+	
+	#endif
+	
+	void
+	print(std::vector<Result> const& results)
+	{
+		ink::benchmark::Print({ { "elements", ELEMENTS }, { "repetitions", REPETITIONS } }, results, [](Result const& res)
+		{
+			std::printf("\"name\": \"%s\", \"ns_per_element\": %.4f, \"max_rel_error\": %.6e, \"mean_rel_error\": %.6e, \"ulp_histogram\": [",
+				res.name.c_str(), res.ns_per_element, res.max_rel_error, res.mean_rel_error);
+			
+			for (size_t b = 0; b < ULP_BUCKETS; b++)
+			{ std::printf("%s%llu", b ? ", " : "", static_cast<unsigned long long>(res.ulp_histogram[b])); }
+			
+			std::printf("]");
+		});
+	}
+	
+}
+
+int
+main()
+{
+	const auto in_f = make_inputs<float>();
+	const auto in_d = make_inputs<double>();
+	
+	std::vector<Result> results;
+	
+	for (size_t extra_iterations = 0; extra_iterations <= 3; extra_iterations++)
+	{
+		const auto suffix = "/extra_iterations=" + std::to_string(extra_iterations);
+		
+		results.push_back(measure("Q_rsqrt<float>" + suffix, in_f, [=](float const* in, float* out, size_t n)
+		{ for (size_t i = 0; i < n; i++) out[i] = ink::Q_rsqrt(in[i], extra_iterations); }));
+		
+		results.push_back(measure("Q_rsqrt<float>[batch]" + suffix, in_f, [=](float const* in, float* out, size_t n)
+		{ ink::Q_rsqrt(std::span<float const>(in, n), std::span<float>(out, n), extra_iterations); }));
+		
+		results.push_back(measure("Q_rsqrt<double>" + suffix, in_d, [=](double const* in, double* out, size_t n)
+		{ for (size_t i = 0; i < n; i++) out[i] = ink::Q_rsqrt(in[i], extra_iterations); }));
+	}
+	
+	results.push_back(measure("1.0f/std::sqrt", in_f, [](float const* in, float* out, size_t n)
+	{ for (size_t i = 0; i < n; i++) out[i] = 1.0F / std::sqrt(in[i]); }));
+	
+	results.push_back(measure("1.0/std::sqrt<double>", in_d, [](double const* in, double* out, size_t n)
+	{ for (size_t i = 0; i < n; i++) out[i] = 1.0 / std::sqrt(in[i]); }));
+	
+	#if defined(INK_VECTOR2_ARRAY_X86)
+	
+	results.push_back(measure("_mm_rsqrt_ps", in_f, hw_rsqrt));
+	results.push_back(measure("_mm_rsqrt_ps+newton", in_f, hw_rsqrt_newton));
+	
+	if (ink::detail::simd::detected_level() >= ink::detail::simd::level::avx512)
+	{ results.push_back(measure("_mm512_rsqrt14_ps", in_f, hw_rsqrt14)); }
+	
+	#endif
+	
+	print(results);
+}
@@ -0,0 +1,181 @@
+/**
+ * Compile-time benchmark for the ink::rebind list algorithms: sort, filter, unique and set algebra. There is nothing to run;
+ * what is measured is the cost of compiling it. The input is a list of INK_REBIND_BENCHMARK_SIZE distinct types of assorted
+ * sizes, which gets sorted by size, filtered, merged with a copy of its first half to be deduplicated, and combined with its
+ * first half by each of the set operations.
+ * With INK_REBIND_BENCHMARK_LEGACY defined, the same work is done by plain recursive implementations instead (insertion
+ * sort, and one concat per element everywhere else), which is what these would be without the flat algorithms.
+ *
+ * Run it through Rebind_Benchmark.sh: Benchmarks/Rebind_Benchmark.sh Algorithms
+ */
+
+#include <array>
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "Rebind.hpp"
+
+#if !defined(INK_REBIND_BENCHMARK_SIZE)
+	#define INK_REBIND_BENCHMARK_SIZE 500
+#endif
+
+namespace {
+	
+	using namespace ink::rebind;
+	// type_list is an alias that cannot be deduced through, so the patterns below match on what it names.
+	using ink::rebind::detail::type_list_impl;
+	
+	template<size_t I> struct
+	tag { char bytes[I * 7919 % 61 + 1]; };
+	
+	template<typename A, typename B> struct
+	smaller
+	{ static constexpr bool value = sizeof(A) < sizeof(B); };
+	
+	template<typename T> struct
+	even
+	{ static constexpr bool value = sizeof(T) % 2 == 0; };
+	
+	constexpr size_t Size = INK_REBIND_BENCHMARK_SIZE;
+	
+	template<typename Sequence> struct
+	make_list;
+	
+	template<size_t... I> struct
+	make_list<std::index_sequence<I...>>
+	{ using type = type_list<tag<I>...>; };
+	
+	using list = typename make_list<std::make_index_sequence<Size>>::type;
+	using half = typename make_list<std::make_index_sequence<Size / 2>>::type;
+	using doubled = typename list::template concat_with<half>;
+	
+	template<typename... types> constexpr bool
+	is_sorted(type_list_impl<types...>*)
+	{
+		std::array<size_t, sizeof...(types)> sizes{sizeof(types)...};
+		for (size_t i = 1; i < sizes.size(); ++i) if (sizes[i] < sizes[i - 1]) return false;
+		return true;
+	}
+	
+	template<typename... types> constexpr size_t
+	count_even(type_list_impl<types...>*)
+	{ return (size_t{0} + ... + size_t{even<types>::value}); }
+	
+	#if defined(INK_REBIND_BENCHMARK_LEGACY)
+	
+	template<typename List, template<typename> typename Pred> struct
+	legacy_filter;
+	
+	template<template<typename> typename Pred> struct
+	legacy_filter<type_list_impl<>, Pred>
+	{ using type = type_list<>; };
+	
+	template<typename T, typename... types, template<typename> typename Pred> struct
+	legacy_filter<type_list_impl<T, types...>, Pred>
+	{
+		using rest = typename legacy_filter<type_list_impl<types...>, Pred>::type;
+		using type = std::conditional_t<Pred<T>::value, typename concat<type_list_impl<T>>::template with<rest>, rest>;
+	};
+	
+	template<typename T, typename List> struct
+	legacy_insert;
+	
+	template<typename T> struct
+	legacy_insert<T, type_list_impl<>>
+	{ using type = type_list_impl<T>; };
+	
+	template<typename T, typename U, typename... types> struct
+	legacy_insert<T, type_list_impl<U, types...>>
+	{
+		struct later { using type = typename concat<type_list_impl<U>>::template with< typename legacy_insert<T, type_list_impl<types...>>::type >; };
+		struct here { using type = type_list_impl<T, U, types...>; };
+		using type = typename std::conditional_t<smaller<U, T>::value, later, here>::type;
+	};
+	
+	template<typename List> struct
+	legacy_sort
+	{ using type = type_list<>; };
+	
+	template<typename T, typename... types> struct
+	legacy_sort<type_list_impl<T, types...>>
+	{ using type = typename legacy_insert<T, typename legacy_sort<type_list_impl<types...>>::type>::type; };
+	
+	template<typename Seen, typename List> struct
+	legacy_unique
+	{ using type = Seen; };
+	
+	template<typename... seen, typename T, typename... types> struct
+	legacy_unique<type_list_impl<seen...>, type_list_impl<T, types...>>
+	{
+		using next = std::conditional_t<(std::is_same_v<T, seen> || ...), type_list_impl<seen...>, type_list_impl<seen..., T>>;
+		using type = typename legacy_unique<next, type_list_impl<types...>>::type;
+	};
+	
+	template<typename T> using
+	in_half_list = std::bool_constant<half::template contains<T>>;
+	
+	template<typename T> using
+	not_in_half_list = std::bool_constant<!half::template contains<T>>;
+	
+	using sorted = typename legacy_sort<list>::type;
+	using filtered = typename legacy_filter<list, even>::type;
+	using uniqued = typename legacy_unique<type_list<>, doubled>::type;
+	using united = typename legacy_unique<type_list<>, doubled>::type;
+	using intersected = typename legacy_unique<type_list<>, typename legacy_filter<list, in_half_list>::type>::type;
+	using differed = typename legacy_unique<type_list<>, typename legacy_filter<list, not_in_half_list>::type>::type;
+	
+	#else
+	
+	using sorted = typename list::template sort_by<smaller>;
+	using filtered = typename list::template filter_with<even>;
+	using uniqued = unique<doubled>;
+	using united = typename list::template union_with<half>;
+	using intersected = typename list::template intersection_with<half>;
+	using differed = typename list::template difference_with<half>;
+	
+	#endif
+	
+	static_assert(sorted::size == Size && is_sorted(static_cast<sorted*>(nullptr)));
+	static_assert(filtered::size == count_even(static_cast<list*>(nullptr)));
+	static_assert(std::is_same_v<uniqued, list>);
+	static_assert(std::is_same_v<united, list>);
+	static_assert(std::is_same_v<intersected, half>);
+	static_assert(differed::size == Size - Size / 2);
+	
+	// Small cases, where the exact results can be spelled out: ties keep their order, and missing types index past the end.
+	using mixed = type_list<double, char, int, short, char, float, double>;
+	static_assert(std::is_same_v<typename mixed::template sort_by<smaller>, type_list<char, char, short, int, float, double, double>>);
+	static_assert(std::is_same_v<typename mixed::template filter_with<std::is_integral>, type_list<char, int, short, char>>);
+	static_assert(std::is_same_v<unique<mixed>, type_list<double, char, int, short, float>>);
+	static_assert(mixed::template index_of<int> == 2 && mixed::template index_of<long> == mixed::size);
+	static_assert(mixed::template contains<float> && !mixed::template contains<long>);
+	static_assert(std::is_same_v<typename mixed::template union_with<type_list<long, int>>, type_list<double, char, int, short, float, long>>);
+	static_assert(std::is_same_v<typename mixed::template intersection_with<type_list<int, double>>, type_list<double, int>>);
+	static_assert(std::is_same_v<typename mixed::template difference_with<type_list<int, double>>, type_list<char, short, float>>);
+	static_assert(std::is_same_v<typename sort<type_list<>>::template by<smaller>, type_list<>>);
+	static_assert(std::is_same_v<unique<type_list<>>, type_list<>>);
+	
+	// Empty results are lists like any other.
+	using none = typename type_list<int, char>::template filter_with<std::is_pointer>;
+	static_assert(std::is_same_v<none, type_list<>>);
+	static_assert(std::is_same_v<typename mixed::template intersection_with<type_list<long>>, type_list<>>);
+	static_assert(std::is_same_v<typename mixed::template difference_with<mixed>, type_list<>>);
+	static_assert(none::size == 0 && !none::template contains<int> && none::template index_of<int> == 0);
+	static_assert(std::is_same_v<typename none::template union_with<type_list<int>>, type_list<int>>);
+	static_assert(std::is_same_v<typename none::template intersection_with<mixed>, type_list<>>);
+	static_assert(std::is_same_v<typename none::template difference_with<mixed>, type_list<>>);
+	static_assert(std::is_same_v<typename none::template filter_with<std::is_integral>, type_list<>>);
+	static_assert(std::is_same_v<typename none::template sort_by<smaller>, type_list<>>);
+	static_assert(std::is_same_v<typename none::template transform_with<std::add_pointer_t>, type_list<>>);
+	static_assert(std::is_same_v<typename none::template concat_with<type_list<int>>, type_list<int>>);
+	static_assert(std::is_same_v<typename none::reverse, type_list<>>);
+	static_assert(std::is_same_v<typename none::template unpack_into<std::tuple>, std::tuple<>>);
+	static_assert(std::is_same_v<typename none::template emplace_onto<std::tuple<int>>, std::tuple<>>);
+	
+}
+
+int
+main()
+{}
@@ -0,0 +1,59 @@
+#!/bin/sh
+# Compile-time benchmarks for ink::rebind; see Rebind_Indexing_Benchmark.cpp, Rebind_Operations_Benchmark.cpp and
+# Rebind_Algorithms_Benchmark.cpp.
+# Run from the repository root, naming the benchmark and optionally the compiler: Benchmarks/Rebind_Benchmark.sh Indexing clang++
+#
+# Prints CSV to stdout, one row per (implementation, list size):
+# 	+ seconds: wall time of the whole compilation.
+# 	+ instantiation_seconds: time spent instantiating templates (GCC, from -ftime-report).
+# 	+ instantiations: number of class template instantiations (Clang, from -ftime-trace).
+# Columns a compiler cannot report are left empty. A compilation running past TIMEOUT seconds (default 120) is cut short,
+# and reported with seconds set to "timeout".
+
+BENCHMARK=${1:-Indexing}
+CXX=${2:-${CXX:-g++}}
+TIMEOUT=${TIMEOUT:-120}
+SOURCE=Benchmarks/Rebind_${BENCHMARK}_Benchmark.cpp
+[ -f "$SOURCE" ] || { echo "no such benchmark: $SOURCE" >&2; exit 1; }
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+
+if "$CXX" --version | grep -q clang; then CLANG=1; else CLANG=0; fi
+
+echo "implementation,elements,seconds,instantiation_seconds,instantiations"
+
+for implementation in legacy rebind; do
+	for elements in 10 50 100 250 500 1000; do
+		flags="-std=c++20 -I. -ftemplate-depth=4096 -DINK_REBIND_BENCHMARK_SIZE=$elements"
+		[ "$implementation" = legacy ] && flags="$flags -DINK_REBIND_BENCHMARK_LEGACY"
+
+		start=$(date +%s%N)
+		if [ $CLANG = 1 ]; then
+			timeout "$TIMEOUT" "$CXX" $flags -ftime-trace -ftime-trace-granularity=0 -c "$SOURCE" -o "$WORK/bench.o"
+		else
+			timeout "$TIMEOUT" "$CXX" $flags -ftime-report -c "$SOURCE" -o "$WORK/bench.o" 2> "$WORK/report.txt"
+		fi
+		status=$?
+		stop=$(date +%s%N)
+
+		if [ $status = 124 ]; then
+			echo "$implementation,$elements,timeout,,"
+			continue
+		elif [ $status != 0 ]; then
+			[ $CLANG = 0 ] && cat "$WORK/report.txt" >&2
+			exit 1
+		fi
+
+		seconds=$(awk "BEGIN { printf \"%.3f\", ($stop - $start) / 1e9 }")
+		instantiation_seconds=""
+		instantiations=""
+		if [ $CLANG = 1 ]; then
+			instantiations=$(grep -o '"name":"InstantiateClass"' "$WORK/bench.json" | wc -l | tr -d ' ')
+		else
+			# Columns are usr, sys and wall time, each followed by a percentage; keep the wall time.
+			instantiation_seconds=$(sed -n 's/^ *template instantiation *: *[0-9.]* *([^)]*) *[0-9.]* *([^)]*) *\([0-9.]*\).*/\1/p' "$WORK/report.txt")
+		fi
+
+		echo "$implementation,$elements,$seconds,$instantiation_seconds,$instantiations"
+	done
+done
@@ -0,0 +1,64 @@
+/**
+ * Compile-time benchmark for ink::rebind list indexing. There is nothing to run; what is measured is the cost of compiling it.
+ * Every index of a list of INK_REBIND_BENCHMARK_SIZE distinct types is looked up once, either through type_list::get, or,
+ * with INK_REBIND_BENCHMARK_LEGACY defined, through std::tuple_element over a std::tuple (the previous implementation).
+ *
+ * Rebind_Benchmark.sh compiles it for a range of sizes with both implementations, and prints the timings as CSV:
+ * Benchmarks/Rebind_Benchmark.sh Indexing
+ */
+
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "Rebind.hpp"
+
+#if !defined(INK_REBIND_BENCHMARK_SIZE)
+	#define INK_REBIND_BENCHMARK_SIZE 100
+#endif
+
+namespace {
+	
+	template<size_t> struct
+	tag {};
+	
+	using Sequence = std::make_index_sequence<INK_REBIND_BENCHMARK_SIZE>;
+	
+	#if defined(INK_REBIND_BENCHMARK_LEGACY)
+	
+	template<typename Sequence> struct
+	make_tuple;
+	
+	template<size_t... I> struct
+	make_tuple<std::index_sequence<I...>>
+	{ using type = std::tuple<tag<I>...>; };
+	
+	template<size_t I> using
+	get = std::tuple_element_t<I, typename make_tuple<Sequence>::type>;
+	
+	#else
+	
+	template<typename Sequence> struct
+	make_list;
+	
+	template<size_t... I> struct
+	make_list<std::index_sequence<I...>>
+	{ using type = ink::rebind::type_list<tag<I>...>; };
+	
+	template<size_t I> using
+	get = typename make_list<Sequence>::type::template get<I>;
+	
+	#endif
+	
+	template<size_t... I> constexpr bool
+	lookup_all(std::index_sequence<I...>)
+	{ return (std::is_same_v<get<I>, tag<I>> && ...); }
+	
+	static_assert(lookup_all(Sequence{}));
+	
+}
+
+int
+main()
+{}
@@ -0,0 +1,91 @@
+/**
+ * Compile-time stress benchmark for ink::rebind reverse, pop_last and repeat::times. There is nothing to run; what is
+ * measured is the cost of compiling it. A list of INK_REBIND_BENCHMARK_SIZE distinct types, and one of as many values, are
+ * reversed and have their last element popped, and a type is repeated INK_REBIND_BENCHMARK_SIZE times.
+ * With INK_REBIND_BENCHMARK_LEGACY defined, the type list operations use the previous, recursive implementations instead
+ * (reverse through one concat per element, pop_last as two reversals, repeat through one concat per repetition); the value
+ * list operations did not exist then, and are left out.
+ *
+ * Run it through Rebind_Benchmark.sh: Benchmarks/Rebind_Benchmark.sh Operations
+ */
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#include "Rebind.hpp"
+
+#if !defined(INK_REBIND_BENCHMARK_SIZE)
+	#define INK_REBIND_BENCHMARK_SIZE 100
+#endif
+
+namespace {
+	
+	using namespace ink::rebind;
+	
+	template<size_t> struct
+	tag {};
+	
+	constexpr size_t Size = INK_REBIND_BENCHMARK_SIZE;
+	
+	template<typename Sequence> struct
+	make_lists;
+	
+	template<size_t... I> struct
+	make_lists<std::index_sequence<I...>>
+	{
+		using types = type_list<tag<I>...>;
+		using reversed_types = type_list<tag<Size - 1 - I>...>;
+		using values = value_list<I...>;
+		using reversed_values = value_list<(Size - 1 - I)...>;
+	};
+	
+	using lists = make_lists<std::make_index_sequence<Size>>;
+	using popped_lists = make_lists<std::make_index_sequence<Size - 1>>;
+	
+	#if defined(INK_REBIND_BENCHMARK_LEGACY)
+	
+	template<typename TypeList> struct
+	legacy_reverse_impl;
+	
+	template<template<typename...> typename List, typename T, typename... Ts> struct
+	legacy_reverse_impl<List<T, Ts...>>
+	{ using type = typename concat< typename legacy_reverse_impl<type_list<Ts...>>::type >::template with<type_list<T>>; };
+	
+	template<template<typename...> typename List> struct
+	legacy_reverse_impl<List<>>
+	{ using type = type_list<>; };
+	
+	template<typename TypeList> using
+	legacy_reverse = typename legacy_reverse_impl<TypeList>::type;
+	
+	template<typename TypeList> using
+	legacy_pop_last = legacy_reverse<pop_first<legacy_reverse<TypeList>>>;
+	
+	template<typename Type, size_t N> struct
+	legacy_repeat_impl
+	{ using type = typename concat< typename legacy_repeat_impl<Type, N - 1>::type >::template with<type_list<Type>>; };
+	
+	template<typename Type> struct
+	legacy_repeat_impl<Type, 0>
+	{ using type = type_list<>; };
+	
+	static_assert(std::is_same_v< legacy_reverse<lists::types>, lists::reversed_types >);
+	static_assert(std::is_same_v< legacy_pop_last<lists::types>, popped_lists::types >);
+	static_assert(legacy_repeat_impl<tag<0>, Size>::type::size == Size);
+	
+	#else
+	
+	static_assert(std::is_same_v< lists::types::reverse, lists::reversed_types >);
+	static_assert(std::is_same_v< lists::types::pop_last, popped_lists::types >);
+	static_assert(std::is_same_v< lists::values::reverse, lists::reversed_values >);
+	static_assert(std::is_same_v< lists::values::pop_last, popped_lists::values >);
+	static_assert(repeat<tag<0>>::times<Size>::size == Size);
+	
+	#endif
+	
+}
+
+int
+main()
+{}
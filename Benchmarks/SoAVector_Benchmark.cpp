@@ -0,0 +1,123 @@
+/**
+ * Partial-field sweep benchmark for ink::soa_vector, against an array-of-structs std::vector<std::tuple<...>>.
+ * Build from the repository root with, e.g.
+ * 	g++ -std=c++20 -O2 -I. Benchmarks/SoAVector_Benchmark.cpp -o SoAVector_Benchmark
+ *
+ * Every container holds the same ELEMENTS rows of a 12-field entity, and every sweep only touches a few of the fields,
+ * the way an entity system loop does. Each sweep is run three ways: over the AoS vector, over the soa_vector's rows
+ * (proxy references), and over the soa_vector's column spans. The results are written to stdout as a single JSON document,
+ * with one entry per (sweep, layout), holding "ns_per_element": best of all repetitions.
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <ranges>
+#include <span>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "Benchmark.hpp"
+#include "SoAVector.hpp"
+
+namespace {
+	
+	constexpr size_t ELEMENTS = size_t(1) << 20;
+	constexpr size_t REPETITIONS = 32;
+	
+	using namespace ink::benchmark;
+	
+	// id, alive, x, y, z, vx, vy, vz, mass, health, layer, flags
+	using Entity = ink::rebind::type_list<uint32_t, bool, float, float, float, float, float, float, double, double, uint16_t, uint64_t>;
+	using AoS = std::vector<Entity::unpack_into<std::tuple>>;
+	using SoA = ink::soa_vector<Entity>;
+	
+	// Both ways round, rows are ranges the standard algorithms take.
+	static_assert(std::ranges::random_access_range<SoA> && std::ranges::random_access_range<const SoA>);
+	
+	enum Field : size_t { ID, ALIVE, X, Y, Z, VX, VY, VZ, MASS, HEALTH, LAYER, FLAGS };
+	
+	constexpr float DT = 1.0F / 60.0F;
+	
+	/**
+	 * Times sweep() over ELEMENTS rows, best of REPETITIONS; checksum() is read after each run to keep the work alive.
+	 */
+	template<typename Sweep, typename Checksum> Result
+	measure(std::string name, Sweep&& sweep, Checksum&& checksum)
+	{
+		return Measure(std::move(name), ELEMENTS, REPETITIONS, [&]
+		{
+			const auto start = Clock::now();
+			sweep();
+			const double elapsed = Since(start);
+			
+			// Keep the optimizer from discarding the sweep.
+			volatile double sink = checksum(); (void)sink;
+			return elapsed;
+		});
+	}
+	
+}
+
+int
+main()
+{
+	AoS aos;
+	SoA soa;
+	aos.reserve(ELEMENTS);
+	soa.reserve(ELEMENTS);
+	for (size_t i = 0; i < ELEMENTS; i++)
+	{
+		const float f = float(i % 1000);
+		aos.emplace_back(uint32_t(i), i % 8 != 0, f, f, f, 1.0F, 2.0F, 3.0F, 1.0 + double(i % 5), 100.0, uint16_t(i % 4), uint64_t(i));
+		soa.emplace_back(uint32_t(i), i % 8 != 0, f, f, f, 1.0F, 2.0F, 3.0F, 1.0 + double(i % 5), 100.0, uint16_t(i % 4), uint64_t(i));
+	}
+	
+	std::vector<Result> results;
+	
+	// Two fields: x += vx * dt.
+	results.push_back(measure("integrate_x/aos", [&]
+	{ for (auto& e : aos) std::get<X>(e) += std::get<VX>(e) * DT; },
+	[&] { return double(std::get<X>(aos[ELEMENTS / 2])); }));
+	
+	results.push_back(measure("integrate_x/soa_rows", [&]
+	{ for (auto e : soa) std::get<X>(e) += std::get<VX>(e) * DT; },
+	[&] { return double(std::get<X>(soa[ELEMENTS / 2])); }));
+	
+	results.push_back(measure("integrate_x/soa_columns", [&]
+	{
+		const std::span<float> x = soa.column<X>();
+		const std::span<float const> vx = soa.column<VX>();
+		for (size_t i = 0; i < x.size(); i++) x[i] += vx[i] * DT;
+	},
+	[&] { return double(soa.column<X>()[ELEMENTS / 2]); }));
+	
+	// Three fields: kinetic energy of the living entities, 0.5 * mass * vx^2.
+	double energy = 0;
+	
+	results.push_back(measure("kinetic_energy/aos", [&]
+	{
+		energy = 0;
+		for (auto const& e : aos) if (std::get<ALIVE>(e)) energy += 0.5 * std::get<MASS>(e) * double(std::get<VX>(e) * std::get<VX>(e));
+	},
+	[&] { return energy; }));
+	
+	results.push_back(measure("kinetic_energy/soa_rows", [&]
+	{
+		energy = 0;
+		for (auto e : std::as_const(soa)) if (std::get<ALIVE>(e)) energy += 0.5 * std::get<MASS>(e) * double(std::get<VX>(e) * std::get<VX>(e));
+	},
+	[&] { return energy; }));
+	
+	results.push_back(measure("kinetic_energy/soa_columns", [&]
+	{
+		const std::span<bool const> alive = std::as_const(soa).column<ALIVE>();
+		const std::span<double const> mass = std::as_const(soa).column<MASS>();
+		const std::span<float const> vx = std::as_const(soa).column<VX>();
+		energy = 0;
+		for (size_t i = 0; i < alive.size(); i++) energy += alive[i] ? 0.5 * mass[i] * double(vx[i] * vx[i]) : 0.0;
+	},
+	[&] { return energy; }));
+	
+	Print({ { "elements", ELEMENTS }, { "repetitions", REPETITIONS } }, results);
+}
@@ -0,0 +1,122 @@
+/**
+ * Throughput benchmark for ink::StateMachines, against dispatching on the state of every entity in entity order.
+ * Build from the repository root with, e.g.
+ * 	g++ -std=c++20 -O2 -I. Benchmarks/StateMachines_Benchmark.cpp -o StateMachines_Benchmark
+ *
+ * ENTITIES entities each hold one of 16 states, picked at random, and a float that every state updates differently.
+ * One tick runs every entity's state once, then moves TRANSITIONS of them (picked at random, the same for both methods)
+ * to another state:
+ * 	+ "entity_order": a switch on each entity's state in turn, as with RunState; transitions write the state in place.
+ * 	+ "bucketed": StateMachines::Run(), each state's handler looping over its whole bucket; transitions are queued,
+ * 	  then applied by StateMachines::Apply().
+ * The results are written to stdout as a single JSON document, with one entry per method, holding "ns_per_element":
+ * best of all repetitions, per entity per tick (transitions included); then the per-state statistics of the bucketed run.
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "Benchmark.hpp"
+#include "Dispatch.hpp"
+#include "StateMachines.hpp"
+
+#define STATES(v) v(S0) v(S1) v(S2) v(S3) v(S4) v(S5) v(S6) v(S7) v(S8) v(S9) v(S10) v(S11) v(S12) v(S13) v(S14) v(S15)
+#define MAKE_STATE STATES
+#define MAKE_STATE_STRINGS Name
+#include "MAKE_STATE.hpp"
+
+namespace {
+	
+	constexpr size_t ENTITIES = size_t(1) << 17;
+	constexpr size_t STATE_COUNT = 16;
+	constexpr size_t TICKS = 16;
+	constexpr size_t TRANSITIONS = ENTITIES / 100;
+	constexpr size_t REPETITIONS = 8;
+	
+	using namespace ink::benchmark;
+	
+	std::vector<float> values(ENTITIES);
+	
+	// What state S does to one entity; different per state, so that none of them fold into another.
+	template<size_t S> inline void
+	step(uint32_t e)
+	{ values[e] = values[e] * (1.0f - float(S) / 64.0f) + float(S); }
+	
+	template<typename Tick> Result
+	measure(std::string name, Tick&& tick)
+	{
+		return Measure(std::move(name), ENTITIES * TICKS, REPETITIONS, [&]
+		{
+			for (size_t t = 0; t < TICKS; t++) tick(t);
+			
+			// Keep the optimizer from discarding the ticks.
+			volatile float sink = values[ENTITIES / 2]; (void)sink;
+		});
+	}
+	
+}
+
+// Declared by MAKE_STATE.hpp, unused here: this benchmark's states act on entities, which RunState has no way to pass.
+#define DEFINE_STATE(l) void l() {}
+STATES(DEFINE_STATE)
+#undef DEFINE_STATE
+
+int
+main()
+{
+	std::mt19937_64 rng(ENTITIES);
+	std::uniform_int_distribution<uint32_t> any_state(0, STATE_COUNT - 1), any_entity(0, ENTITIES - 1);
+	
+	std::vector<State> initial(ENTITIES);
+	for (auto& s : initial) s = State(any_state(rng));
+	
+	// The transitions of every tick: (entity, new state).
+	std::vector<std::pair<uint32_t, State>> transitions(TICKS * TRANSITIONS);
+	for (auto& [e, s] : transitions) { e = any_entity(rng); s = State(any_state(rng)); }
+	
+	std::vector<Result> results;
+	
+	std::vector<State> states;
+	results.push_back(measure("entity_order", [&](size_t t)
+	{
+		if (t == 0) states = initial;
+		for (uint32_t e = 0; e < ENTITIES; e++)
+		{ ink::dispatch_index<STATE_COUNT>(size_t(states[e]), [&]<size_t S>(std::integral_constant<size_t, S>) { step<S>(e); }); }
+		for (size_t i = t * TRANSITIONS; i < (t + 1) * TRANSITIONS; i++) states[transitions[i].first] = transitions[i].second;
+	}));
+	
+	ink::StateMachines<State, STATE_COUNT> machines;
+	results.push_back(measure("bucketed", [&](size_t t)
+	{
+		if (t == 0)
+		{
+			for (uint32_t e = 0; e < ENTITIES; e++) machines.Add(e, initial[e]);
+			machines.Apply();
+			machines.ResetStatistics();
+		}
+		machines.Run([&](State s, std::span<const uint32_t> ids)
+		{ ink::dispatch_index<STATE_COUNT>(size_t(s), [&]<size_t S>(std::integral_constant<size_t, S>) { for (uint32_t e : ids) step<S>(e); }); });
+		for (size_t i = t * TRANSITIONS; i < (t + 1) * TRANSITIONS; i++) machines.Transition(transitions[i].first, transitions[i].second);
+		machines.Apply();
+	}));
+	
+	Print({ { "elements", ENTITIES }, { "ticks", TICKS }, { "repetitions", REPETITIONS } }, results, PrintEntry, [&]
+	{
+		std::printf(",\n\t\"states\": [\n");
+		for (size_t s = 0; s < STATE_COUNT; s++)
+		{
+			auto const& stat = machines.Statistics(State(s));
+			std::printf("\t\t{ \"name\": \"%s\", \"entities\": %zu, \"runs\": %llu, \"entered\": %llu, \"left\": %llu, \"ns_per_entity\": %.4f, \"max_ns\": %lld }%s\n",
+				Name(State(s)), machines.Entities(State(s)).size(), (unsigned long long)stat.runs, (unsigned long long)stat.entered,
+				(unsigned long long)stat.left, double(stat.total_time.count()) / double(std::max<uint64_t>(stat.handled, 1)),
+				(long long)stat.max_time.count(), s + 1 < STATE_COUNT ? "," : "");
+		}
+		std::printf("\t]");
+	});
+}
@@ -0,0 +1,180 @@
+/**
+ * Cost benchmark for ink::StateTask states, run by an ink::StateScheduler, against the plain function-pointer RunState
+ * of MAKE_STATE_TABLE.
+ * Build from the repository root with, e.g.
+ * 	g++ -std=c++20 -O2 -I. Benchmarks/StateTask_Benchmark.cpp -o StateTask_Benchmark
+ *
+ * ACTORS actors patrol: they walk for WALK ticks, then rest for REST ticks, and so on. Measured:
+ * 	+ "frames/heap": making, then destroying, one frame per actor of a coroutine whose promise uses the global operator new.
+ * 	+ "frames/pool": the same with StateTask, whose frames come from the FramePool.
+ * 	+ "tick/RunState": a tick of the patrol as two MAKE_STATE_TABLE states, Walk(actor) and Rest(actor), with RunState on
+ * 	  every actor; each actor keeps its own state and tick counter.
+ * 	+ "tick/StateTask": a tick of the same patrol as two StateTask states, which count their ticks in their own locals,
+ * 	  each spawning the other when done; StateScheduler::Tick() resumes every actor.
+ * Both patrols must end with the same actors; the benchmark fails otherwise.
+ * The results are written to stdout as a single JSON document, with one entry per method, holding "ns_per_element":
+ * best of all repetitions, per actor (per actor per tick, for "tick/...").
+ */
+
+#include <coroutine>
+#include <cstdint>
+#include <cstdio>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "Benchmark.hpp"
+#include "StateTask.hpp"
+
+namespace {
+	
+	constexpr size_t ACTORS = 100'000;
+	constexpr size_t TICKS = 64;
+	constexpr size_t REPETITIONS = 8;
+	constexpr uint32_t WALK = 8, REST = 4;
+	
+	struct Actor
+	{
+		uint32_t x = 0;
+		uint32_t rested = 0;
+		
+		// Only used by the RunState patrol, whose states cannot keep their own progress.
+		uint8_t state = 0;
+		uint32_t ticks = 0;
+	};
+	
+	// A coroutine like StateTask, but with frames from the global operator new.
+	struct HeapTask
+	{
+		struct promise_type
+		{
+			HeapTask get_return_object() { return HeapTask{ std::coroutine_handle<promise_type>::from_promise(*this) }; }
+			std::suspend_always initial_suspend() noexcept { return {}; }
+			std::suspend_always final_suspend() noexcept { return {}; }
+			void return_void() {}
+			void unhandled_exception() { throw; }
+		};
+		std::coroutine_handle<promise_type> handle;
+	};
+	
+}
+
+namespace plain {
+	
+	#define MAKE_STATE(v) v(Walk) v(Rest)
+	#define MAKE_STATE_TABLE
+	#define MAKE_STATE_PARAMETERS Actor& actor
+	#define MAKE_STATE_ARGUMENTS actor
+	#include "MAKE_STATE.hpp"
+	
+	void
+	Walk(Actor& actor)
+	{
+		actor.x++;
+		if (++actor.ticks == WALK) { actor.ticks = 0; actor.state = uint8_t(State::Rest); }
+	}
+	
+	void
+	Rest(Actor& actor)
+	{
+		actor.rested++;
+		if (++actor.ticks == REST) { actor.ticks = 0; actor.state = uint8_t(State::Walk); }
+	}
+	
+}
+
+namespace coroutine {
+	
+	#define MAKE_STATE(v) v(Walk) v(Rest)
+	#define MAKE_STATE_TABLE
+	#define MAKE_STATE_RETURN_TYPE ink::StateTask
+	#define MAKE_STATE_PARAMETERS Actor& actor
+	#define MAKE_STATE_ARGUMENTS actor
+	#include "MAKE_STATE.hpp"
+	
+	ink::StateTask
+	Walk(Actor& actor)
+	{
+		for (uint32_t tick = 0; tick < WALK; tick++) { if (tick > 0) co_await ink::NextTick{}; actor.x++; }
+		ink::StateScheduler::Current()->Spawn(RunState(State::Rest, actor));
+	}
+	
+	ink::StateTask
+	Rest(Actor& actor)
+	{
+		for (uint32_t tick = 0; tick < REST; tick++) { if (tick > 0) co_await ink::NextTick{}; actor.rested++; }
+		ink::StateScheduler::Current()->Spawn(RunState(State::Walk, actor));
+	}
+	
+	HeapTask
+	HeapWalk(Actor& actor)
+	{
+		for (uint32_t tick = 0; tick < WALK; tick++) { if (tick > 0) co_await std::suspend_always{}; actor.x++; }
+	}
+	
+}
+
+namespace {
+	
+	using namespace ink::benchmark;
+	
+	// Best time of run(), which does its own setup and returns the nanoseconds it spent on what is measured.
+	template<typename Run> Result
+	measure(std::string name, size_t elements, Run&& run)
+	{ return Measure(std::move(name), elements, REPETITIONS, std::forward<Run>(run)); }
+	
+}
+
+int
+main()
+{
+	std::vector<Result> results;
+	std::vector<Actor> actors(ACTORS);
+	
+	results.push_back(measure("frames/heap", ACTORS, [&] {
+		std::vector<HeapTask> tasks; tasks.reserve(ACTORS);
+		const auto start = Clock::now();
+		for (Actor& actor : actors) tasks.push_back(coroutine::HeapWalk(actor));
+		for (HeapTask& task : tasks) task.handle.destroy();
+		return Since(start);
+	}));
+	
+	results.push_back(measure("frames/pool", ACTORS, [&] {
+		std::vector<ink::StateTask> tasks; tasks.reserve(ACTORS);
+		const auto start = Clock::now();
+		for (Actor& actor : actors) tasks.push_back(coroutine::RunState(coroutine::State::Walk, actor));
+		tasks.clear();
+		return Since(start);
+	}));
+	
+	std::vector<Actor> plain_actors, coroutine_actors;
+	
+	results.push_back(measure("tick/RunState", ACTORS * TICKS, [&] {
+		plain_actors.assign(ACTORS, Actor{});
+		const auto start = Clock::now();
+		for (size_t tick = 0; tick < TICKS; tick++)
+			for (Actor& actor : plain_actors) plain::RunState(plain::State(actor.state), actor);
+		return Since(start);
+	}));
+	
+	results.push_back(measure("tick/StateTask", ACTORS * TICKS, [&] {
+		coroutine_actors.assign(ACTORS, Actor{});
+		ink::StateScheduler scheduler;
+		for (Actor& actor : coroutine_actors) scheduler.Spawn(coroutine::RunState(coroutine::State::Walk, actor));
+		const auto start = Clock::now();
+		for (size_t tick = 0; tick < TICKS; tick++) scheduler.Tick();
+		return Since(start);
+	}));
+	
+	Print({ { "elements", ACTORS }, { "ticks", TICKS }, { "repetitions", REPETITIONS } }, results);
+	
+	for (size_t i = 0; i < ACTORS; i++)
+	{
+		if (plain_actors[i].x != coroutine_actors[i].x || plain_actors[i].rested != coroutine_actors[i].rested)
+		{
+			std::fprintf(stderr, "The two patrols disagree\n");
+			return 1;
+		}
+	}
+}
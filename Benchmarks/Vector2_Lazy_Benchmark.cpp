@@ -0,0 +1,141 @@
+/**
+ * Cost benchmark for ink::lazy expressions over Vector2 and Vector2Array, against the eager operators.
+ * Build from the repository root with, e.g.
+ * 	g++ -std=c++20 -O2 -I. Benchmarks/Vector2_Lazy_Benchmark.cpp -o Vector2_Lazy_Benchmark
+ *
+ * Every method computes r = a * s + b - c. Measured:
+ * 	+ "vector2/eager" and "vector2/lazy": over ELEMENTS Vector2<Poly>, a heap-backed element type; eagerly, every step
+ * 	  makes a Vector2 of two new Polys, while lazily each component is a single chain that moves one Poly along.
+ * 	+ "array/eager": over Vector2Array<float>, each operator making an array of its own; three passes, two temporaries.
+ * 	+ "array/in_place": the same with r = a; r *= s; r += b; r -= c; four passes, no temporaries.
+ * 	+ "array/lazy": the same as one lazy expression, evaluated in a single vectorized pass.
+ * Every method of a group must agree with the others; the benchmark fails otherwise. Array results need only agree to a
+ * few ulps of the operands, as a compiler allowed to contract (e.g. -march=native with FMA) may fuse a * s + b once it
+ * is in one loop.
+ * The results are written to stdout as a single JSON document, with one entry per method, holding "ns_per_element":
+ * best of all repetitions, per vector.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Benchmark.hpp"
+#include "Vector2Array.hpp"
+
+namespace {
+	
+	constexpr size_t ELEMENTS = size_t(1) << 16;
+	constexpr size_t ARRAY_ELEMENTS = size_t(1) << 20;
+	constexpr size_t REPETITIONS = 16;
+	constexpr size_t TERMS = 8;
+	
+	using namespace ink::benchmark;
+	
+	// A polynomial of TERMS coefficients: the kind of element whose every temporary costs an allocation.
+	struct Poly
+	{
+		std::vector<double> c = std::vector<double>(TERMS);
+		
+		bool operator==(Poly const&) const = default;
+	};
+	
+	Poly operator*(Poly const& p, double s) { Poly out; for (size_t i = 0; i < TERMS; i++) out.c[i] = p.c[i] * s; return out; }
+	Poly operator+(Poly const& p, Poly const& q) { Poly out; for (size_t i = 0; i < TERMS; i++) out.c[i] = p.c[i] + q.c[i]; return out; }
+	Poly operator-(Poly const& p, Poly const& q) { Poly out; for (size_t i = 0; i < TERMS; i++) out.c[i] = p.c[i] - q.c[i]; return out; }
+	
+	// Reuse the storage of a temporary on the left.
+	Poly operator+(Poly&& p, Poly const& q) { for (size_t i = 0; i < TERMS; i++) p.c[i] += q.c[i]; return std::move(p); }
+	Poly operator-(Poly&& p, Poly const& q) { for (size_t i = 0; i < TERMS; i++) p.c[i] -= q.c[i]; return std::move(p); }
+	
+	// Best time of run(), which does its own setup and returns the nanoseconds it spent on what is measured.
+	template<typename Run> Result
+	measure(std::string name, size_t elements, Run&& run)
+	{ return Measure(std::move(name), elements, REPETITIONS, std::forward<Run>(run)); }
+	
+}
+
+int
+main()
+{
+	std::vector<Result> results;
+	std::mt19937 rng(42);
+	std::uniform_real_distribution<float> dist(-100.0f, 100.0f);
+	
+	using PolyVector = ink::Vector2<Poly>;
+	std::vector<PolyVector> pa, pb, pc;
+	for (size_t i = 0; i < ELEMENTS; i++)
+	{
+		PolyVector a, b, c;
+		for (size_t t = 0; t < TERMS; t++)
+		{
+			a.x.c[t] = dist(rng); a.y.c[t] = dist(rng);
+			b.x.c[t] = dist(rng); b.y.c[t] = dist(rng);
+			c.x.c[t] = dist(rng); c.y.c[t] = dist(rng);
+		}
+		pa.push_back(a); pb.push_back(b); pc.push_back(c);
+	}
+	const double ps = 1.5;
+	std::vector<PolyVector> eager_polys(ELEMENTS), lazy_polys(ELEMENTS);
+	
+	results.push_back(measure("vector2/eager", ELEMENTS, [&] {
+		const auto start = Clock::now();
+		for (size_t i = 0; i < ELEMENTS; i++) eager_polys[i] = pa[i] * ps + pb[i] - pc[i];
+		return Since(start);
+	}));
+	
+	results.push_back(measure("vector2/lazy", ELEMENTS, [&] {
+		const auto start = Clock::now();
+		for (size_t i = 0; i < ELEMENTS; i++) lazy_polys[i] = ink::lazy(pa[i]) * ps + pb[i] - pc[i];
+		return Since(start);
+	}));
+	
+	ink::Vector2Array<float> a(ARRAY_ELEMENTS), b(ARRAY_ELEMENTS), c(ARRAY_ELEMENTS);
+	for (size_t i = 0; i < ARRAY_ELEMENTS; i++)
+	{
+		a.set(i, { dist(rng), dist(rng) });
+		b.set(i, { dist(rng), dist(rng) });
+		c.set(i, { dist(rng), dist(rng) });
+	}
+	const float s = 1.5f;
+	ink::Vector2Array<float> eager, in_place, fused;
+	
+	results.push_back(measure("array/eager", ARRAY_ELEMENTS, [&] {
+		const auto start = Clock::now();
+		eager = a * s + b - c;
+		return Since(start);
+	}));
+	
+	results.push_back(measure("array/in_place", ARRAY_ELEMENTS, [&] {
+		const auto start = Clock::now();
+		in_place = a; in_place *= s; in_place += b; in_place -= c;
+		return Since(start);
+	}));
+	
+	results.push_back(measure("array/lazy", ARRAY_ELEMENTS, [&] {
+		const auto start = Clock::now();
+		fused = ink::lazy(a) * s + b - c;
+		return Since(start);
+	}));
+	
+	Print({ { "elements", ELEMENTS }, { "array_elements", ARRAY_ELEMENTS }, { "repetitions", REPETITIONS } }, results);
+	
+	if (!std::equal(eager_polys.begin(), eager_polys.end(), lazy_polys.begin(), [](PolyVector const& p, PolyVector const& q) { return p.x == q.x && p.y == q.y; }))
+	{
+		std::fprintf(stderr, "The Vector2 methods disagree\n");
+		return 1;
+	}
+	
+	auto close = [](float p, float q) { return std::abs(p - q) <= 1e-3f; };	// Operands are within +-100, so an ulp is under 1e-5.
+	auto same = [&](ink::Vector2Array<float> const& p, ink::Vector2Array<float> const& q)
+	{ return std::ranges::equal(p.xs(), q.xs(), close) && std::ranges::equal(p.ys(), q.ys(), close); };
+	if (!same(eager, in_place) || !same(eager, fused))
+	{
+		std::fprintf(stderr, "The array methods disagree\n");
+		return 1;
+	}
+}
@@ -0,0 +1,144 @@
+#ifndef INK_UTILITY_DISPATCH_HEADER_FILE_GUARD
+#define INK_UTILITY_DISPATCH_HEADER_FILE_GUARD
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#include "Rebind.hpp"
+
+// Lists of up to this many alternatives (16 at most) are dispatched through a switch, and longer ones through a table of function pointers.
+#if !defined(INK_DISPATCH_SWITCH_LIMIT)
+	#define INK_DISPATCH_SWITCH_LIMIT 16
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+	#define INK_DISPATCH_UNREACHABLE() __assume(false)
+#else
+	#define INK_DISPATCH_UNREACHABLE() __builtin_unreachable()
+#endif
+
+namespace ink {
+	
+	namespace detail {
+		
+		template<size_t I> using
+		index_constant = std::integral_constant<size_t, I>;
+		
+		// Every alternative must give back the same type, as with std::visit; this is the one the first gives back.
+		template<typename F> using
+		dispatch_result = decltype(std::declval<F>()(index_constant<0>{}));
+		
+		/**
+		 * One function per alternative, all of the same type, gathered into a constexpr array; a dispatch is then a single
+		 * indexed load and an indirect call, whatever the number of alternatives.
+		 */
+		template<typename F, typename Sequence>
+		struct dispatch_table;
+		
+		template<typename F, size_t... I>
+		struct dispatch_table<F, std::index_sequence<I...>> {
+			
+			template<size_t Index> static constexpr dispatch_result<F>
+			entry(F&& f)
+			{ return std::forward<F>(f)(index_constant<Index>{}); }
+			
+			static constexpr dispatch_result<F>(*entries[])(F&&) = { &entry<I>... };
+			
+		};
+		
+		// Cases past N are discarded, so a single switch of 16 cases serves every list up to that size.
+		#define INK_DISPATCH_CASE(k) case k: if constexpr (k < N) return std::forward<F>(f)(index_constant<k>{}); else INK_DISPATCH_UNREACHABLE();
+		
+		/**
+		 * Direct calls from a switch; the compiler lays the switch out as it sees fit (usually as its own jump table),
+		 * and can inline every alternative, where the table can only call through a pointer.
+		 */
+		template<size_t N, typename F> constexpr dispatch_result<F>
+		dispatch_switch(size_t index, F&& f)
+		{
+			static_assert(N <= 16, "dispatch_switch covers at most 16 alternatives");
+			switch (index)
+			{
+				INK_DISPATCH_CASE(0) INK_DISPATCH_CASE(1) INK_DISPATCH_CASE(2) INK_DISPATCH_CASE(3)
+				INK_DISPATCH_CASE(4) INK_DISPATCH_CASE(5) INK_DISPATCH_CASE(6) INK_DISPATCH_CASE(7)
+				INK_DISPATCH_CASE(8) INK_DISPATCH_CASE(9) INK_DISPATCH_CASE(10) INK_DISPATCH_CASE(11)
+				INK_DISPATCH_CASE(12) INK_DISPATCH_CASE(13) INK_DISPATCH_CASE(14) INK_DISPATCH_CASE(15)
+				default: INK_DISPATCH_UNREACHABLE();
+			}
+		}
+		
+		#undef INK_DISPATCH_CASE
+		
+		template<size_t N, typename F> constexpr dispatch_result<F>
+		dispatch_table_call(size_t index, F&& f)
+		{ return dispatch_table<F, std::make_index_sequence<N>>::entries[index](std::forward<F>(f)); }
+		
+		// Turns an index callback into a type callback over the types of List.
+		template<typename List, typename F>
+		struct dispatch_types;
+		
+		template<typename... Ts, typename F>
+		struct dispatch_types<rebind::detail::type_list_impl<Ts...>, F> {
+			
+			F&& f;
+			
+			template<size_t I> constexpr decltype(auto)
+			operator()(index_constant<I>) const
+			{ return std::forward<F>(f)(std::type_identity<rebind::detail::nth_type<I, Ts...>>{}); }
+			
+		};
+		
+	}
+	
+	// How dispatch picks its alternative; automatic picks by the number of alternatives, against INK_DISPATCH_SWITCH_LIMIT.
+	enum class dispatch_strategy { automatic, switch_, table };
+	
+	/**
+	 * Calls f(std::integral_constant<size_t, index>{}), for a runtime index in [0, N). Every call must return the same type.
+	 * An index out of range is undefined behaviour; nothing checks it.
+	 */
+	template<size_t N, dispatch_strategy Strategy = dispatch_strategy::automatic, typename F> constexpr decltype(auto)
+	dispatch_index(size_t index, F&& f)
+	{
+		static_assert(N > 0, "nothing to dispatch to");
+		if constexpr (Strategy == dispatch_strategy::table || (Strategy == dispatch_strategy::automatic && (N > INK_DISPATCH_SWITCH_LIMIT || N > 16)))
+		{ return detail::dispatch_table_call<N>(index, std::forward<F>(f)); }
+		else
+		{ return detail::dispatch_switch<N>(index, std::forward<F>(f)); }
+	}
+	
+	/**
+	 * Calls f(std::type_identity<T>{}), with T the index-th type of List:
+	 *
+	 * 	using Shapes = ink::rebind::type_list<Circle, Square, Triangle>;
+	 * 	const float area = ink::dispatch<Shapes>(kind, [&]<typename T>(std::type_identity<T>) { return T::Area(size); });
+	 */
+	template<typename List, dispatch_strategy Strategy = dispatch_strategy::automatic, typename F> constexpr decltype(auto)
+	dispatch(size_t index, F&& f)
+	{ return dispatch_index<rebind::size_of<List>::value, Strategy>(index, detail::dispatch_types<List, F>{ std::forward<F>(f) }); }
+	
+	/**
+	 * std::visit for a single tagged union, over the same dispatch. Union is any template over its alternatives (a
+	 * std::variant, or anything shaped like it), with an index() member, and a get<I>(u) found by lookup or by ADL:
+	 *
+	 * 	std::variant<Circle, Square, Triangle> shape = ...;
+	 * 	const float area = ink::visit([](auto const& s) { return s.Area(); }, shape);
+	 *
+	 * A valueless std::variant is undefined behaviour, where std::visit throws std::bad_variant_access.
+	 */
+	template<dispatch_strategy Strategy = dispatch_strategy::automatic, typename F, typename Union> constexpr decltype(auto)
+	visit(F&& f, Union&& u)
+	{
+		constexpr size_t N = rebind::pack<std::remove_cvref_t<Union>>::size;
+		return dispatch_index<N, Strategy>(size_t(u.index()), [&]<size_t I>(std::integral_constant<size_t, I>) -> decltype(auto) {
+			using std::get;
+			return std::forward<F>(f)(get<I>(std::forward<Union>(u)));
+		});
+	}
+	
+}
+
+#undef INK_DISPATCH_UNREACHABLE
+
+#endif
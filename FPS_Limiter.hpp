@@ -1,27 +1,157 @@
 #ifndef INK_UTILITY_FPS_LIMITER_HEADER_FILE_GUARD
 #define INK_UTILITY_FPS_LIMITER_HEADER_FILE_GUARD
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
 #include <chrono>
 #include <thread>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#include <immintrin.h>
+	#define INK_FPS_LIMITER_RELAX() _mm_pause()
+#elif defined(__aarch64__) || defined(__arm__)
+	#define INK_FPS_LIMITER_RELAX() __asm__ __volatile__("yield")
+#else
+	#define INK_FPS_LIMITER_RELAX() ((void)0)
+#endif
+
 namespace ink {
 	
+	#if !defined(INK_FPS_LIMITER_NO_STATS)
+	
+	/**
+	 * Rolling frame-timing statistics, written by the thread running FPS_Limiter::Update() and readable from any other thread.
+	 * Every field is an individual relaxed atomic with a single writer, so recording a frame costs a handful of plain stores,
+	 * and a Snapshot is consistent per field (but may straddle a frame boundary between fields).
+	 *
+	 * Define INK_FPS_LIMITER_NO_STATS before including this header to remove the statistics from FPS_Limiter entirely.
+	 */
+	class FrameStatistics {
+		
+		public: static constexpr size_t WINDOW = 256;			// Number of most recent frame times kept for percentiles.
+		public: static constexpr size_t JITTER_BUCKETS = 16;	// Bucket 0 is [0,1) us, bucket k is [2^(k-1), 2^k) us, the last is open-ended.
+		
+		public: struct Snapshot {
+			uint64_t frames = 0;					// Frames recorded since construction.
+			uint64_t missed = 0;					// Frames that finished past their deadline.
+			std::chrono::nanoseconds p50{}, p95{}, p99{}, max{};	// Over the last min(frames, WINDOW) frame times.
+			std::chrono::nanoseconds overshoot{};	// Moving average of how far past their target sleeps have woken up.
+			std::array<uint64_t, JITTER_BUCKETS> jitter{};	// Histogram of |frame time - period|.
+		};
+		
+		public:
+		FrameStatistics() = default;
+		
+		public:
+		FrameStatistics(FrameStatistics const& other)
+		{ *this = other; }
+		
+		public: FrameStatistics&
+		operator=(FrameStatistics const& other)
+		{
+			for (size_t i = 0; i < WINDOW; i++) Copy(frame_times[i], other.frame_times[i]);
+			for (size_t i = 0; i < JITTER_BUCKETS; i++) Copy(jitter[i], other.jitter[i]);
+			Copy(frames, other.frames); Copy(missed, other.missed); Copy(overshoot, other.overshoot);
+			return *this;
+		}
+		
+		// Writer side. Records one full frame (Update() to Update()) against the target period.
+		public: void
+		RecordFrame(std::chrono::nanoseconds frame_time, std::chrono::nanoseconds period, bool missed_deadline)
+		{
+			const uint64_t n = frames.load(std::memory_order_relaxed);
+			frame_times[n % WINDOW].store(frame_time.count(), std::memory_order_relaxed);
+			
+			const uint64_t jitter_us = static_cast<uint64_t>((frame_time > period ? frame_time - period : period - frame_time).count()) / 1000;
+			auto& bucket = jitter[std::min<size_t>(std::bit_width(jitter_us), JITTER_BUCKETS - 1)];
+			bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+			
+			if (missed_deadline) missed.store(missed.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+			
+			frames.store(n + 1, std::memory_order_release);
+		}
+		
+		// Writer side. Records how far past its target a sleep woke up.
+		public: void
+		RecordOvershoot(std::chrono::nanoseconds overshoot)
+		{
+			const int64_t average = this->overshoot.load(std::memory_order_relaxed);
+			this->overshoot.store(average + (overshoot.count() - average) / 8, std::memory_order_relaxed);
+		}
+		
+		// Reader side. Percentiles are computed here, so the cost stays off the writer.
+		public: Snapshot
+		Read() const
+		{
+			Snapshot out;
+			out.frames = frames.load(std::memory_order_acquire);
+			out.missed = missed.load(std::memory_order_relaxed);
+			out.overshoot = std::chrono::nanoseconds{ overshoot.load(std::memory_order_relaxed) };
+			for (size_t i = 0; i < JITTER_BUCKETS; i++) out.jitter[i] = jitter[i].load(std::memory_order_relaxed);
+			
+			const size_t count = std::min<uint64_t>(out.frames, WINDOW);
+			if (count == 0) return out;
+			
+			std::array<int64_t, WINDOW> sorted;
+			for (size_t i = 0; i < count; i++) sorted[i] = frame_times[i].load(std::memory_order_relaxed);
+			std::sort(sorted.begin(), sorted.begin() + count);
+			
+			auto percentile = [&](size_t p) { return std::chrono::nanoseconds{ sorted[(count - 1) * p / 100] }; };
+			out.p50 = percentile(50); out.p95 = percentile(95); out.p99 = percentile(99); out.max = percentile(100);
+			
+			return out;
+		}
+		
+		private: template<typename T> static void
+		Copy(std::atomic<T>& to, std::atomic<T> const& from)
+		{ to.store(from.load(std::memory_order_relaxed), std::memory_order_relaxed); }
+		
+		private: std::array<std::atomic<int64_t>, WINDOW> frame_times{};
+		private: std::array<std::atomic<uint64_t>, JITTER_BUCKETS> jitter{};
+		private: std::atomic<uint64_t> frames{0}, missed{0};
+		private: std::atomic<int64_t> overshoot{0};
+		
+	};
+	
+	#endif
+	
+	/**
+	 * Limits the rate at which Update() returns to at most FPS times per second.
+	 *
+	 * By default the period is rounded to whole milliseconds and waited out with a single sleep_for.
+	 * In precise mode (see SetPrecise) the period has nanosecond resolution, and frames are scheduled against absolute
+	 * deadlines spaced exactly one period apart, so neither rounding nor oversleeping accumulates from frame to frame.
+	 * Each wait is a coarse sleep_until, followed by a spin-wait over the last stretch before the deadline; the length of that
+	 * stretch adapts to how far past its target the OS has been observed to oversleep. The spin polls the clock with a CPU
+	 * pause hint between reads rather than yielding, since a yield may not come back before the deadline.
+	 *
+	 * Unless INK_FPS_LIMITER_NO_STATS is defined, every Update() also records into a FrameStatistics, readable through Statistics().
+	 */
 	struct FPS_Limiter {
 		using HRC = std::chrono::high_resolution_clock;
+		using SC = std::chrono::steady_clock;
 		
-		FPS_Limiter(ptrdiff_t FPS = 60):
-		FPS(FPS) {}
+		FPS_Limiter(ptrdiff_t FPS = 60, bool precise = false):
+		FPS(FPS), precise(precise) {}
 		
 		int64_t
 		Update()
 		{
+			if (precise) return UpdatePrecise();
+			
 			HRC::duration HZ = std::chrono::milliseconds{ 1000 / FPS };
 			
 			tick_diff = HRC::now() - tick_start;
 			( ( (HZ - tick_diff).count() > 0 ) || [&]()constexpr{ std::this_thread::sleep_for( HZ - tick_diff ); return true; }());
 			
+			const HRC::time_point previous = tick_start;
 			tick_start = HRC::now();
 			
+			// The first call has no frame before it: tick_start was still the epoch.
+			if (previous != HRC::time_point{}) RecordFrame(tick_start - previous, HZ, tick_diff > HZ);
+			
 			return tick_diff.count();
 		}
 		
@@ -29,13 +159,115 @@ namespace ink {
 		Set(ptrdiff_t FPS)
 		{ this->FPS = FPS; }
 		
+		// Switch between the default millisecond sleep and the precise deadline-scheduled sleep/spin mode.
+		// Both modes restart, so the first frame after the switch is not measured from a frame of the other mode.
+		void
+		SetPrecise(bool precise)
+		{ this->precise = precise; deadline = {}; precise_start = {}; tick_start = {}; }
+		
+		// How long before each deadline the precise mode stops sleeping and starts spinning.
+		std::chrono::nanoseconds
+		SpinThreshold() const
+		{ return spin_threshold; }
+		
+		// Blocks until deadline with the precise mode's coarse sleep followed by a spin-wait, adapting the spin threshold as it goes.
+		// Usable on its own, e.g. by a scheduler that computes its own deadlines.
+		void
+		WaitUntil(SC::time_point deadline)
+		{
+			const SC::time_point sleep_target = deadline - spin_threshold;
+			if (sleep_target > SC::now())
+			{
+				std::this_thread::sleep_until(sleep_target);
+				const std::chrono::nanoseconds overshoot = SC::now() - sleep_target;
+				Adapt(overshoot);
+				RecordOvershoot(overshoot);
+			}
+			
+			while (SC::now() < deadline)
+			{ INK_FPS_LIMITER_RELAX(); }
+		}
+		
+		#if !defined(INK_FPS_LIMITER_NO_STATS)
+		// Frame-timing statistics. Safe to read from any thread while another one is calling Update().
+		FrameStatistics const&
+		Statistics() const
+		{ return stats; }
+		#endif
+		
 		private:
+		// Bounds of the adaptive spin threshold.
+		static constexpr std::chrono::nanoseconds MIN_SPIN = std::chrono::microseconds{ 50 };
+		static constexpr std::chrono::nanoseconds MAX_SPIN = std::chrono::milliseconds{ 2 };
+		
+		int64_t
+		UpdatePrecise()
+		{
+			const std::chrono::nanoseconds period{ 1'000'000'000 / FPS };
+			
+			SC::time_point now = SC::now();
+			tick_diff = std::chrono::duration_cast<HRC::duration>(now - precise_start);
+			
+			// Advance by exactly one period; if the frame overran its deadline, restart the schedule from now instead of bursting to catch up.
+			deadline = (deadline == SC::time_point{}) ? now + period : deadline + period;
+			const bool missed = deadline < now;
+			if (missed) deadline = now;
+			
+			WaitUntil(deadline);
+			
+			const SC::time_point previous = precise_start;
+			precise_start = SC::now();
+			
+			if (previous != SC::time_point{}) RecordFrame(precise_start - previous, period, missed);
+			
+			return tick_diff.count();
+		}
+		
+		// Grows the spin threshold immediately on a larger oversleep, and lets it decay slowly towards smaller ones.
+		void
+		Adapt(std::chrono::nanoseconds overshoot)
+		{
+			if (overshoot > overshoot_estimate)	overshoot_estimate = overshoot;
+			else								overshoot_estimate -= (overshoot_estimate - overshoot) / 16;
+			
+			spin_threshold = std::clamp(overshoot_estimate + overshoot_estimate / 4, MIN_SPIN, MAX_SPIN);
+		}
+		
+		// Statistics hooks; empty, and so free, when compiled out.
+		void
+		RecordFrame([[maybe_unused]] std::chrono::nanoseconds frame_time, [[maybe_unused]] std::chrono::nanoseconds period, [[maybe_unused]] bool missed)
+		{
+			#if !defined(INK_FPS_LIMITER_NO_STATS)
+			stats.RecordFrame(frame_time, period, missed);
+			#endif
+		}
+		
+		void
+		RecordOvershoot([[maybe_unused]] std::chrono::nanoseconds overshoot)
+		{
+			#if !defined(INK_FPS_LIMITER_NO_STATS)
+			stats.RecordOvershoot(overshoot);
+			#endif
+		}
+		
 		ptrdiff_t FPS = 60;
 		HRC::time_point tick_start{HRC::duration(0)};
 		HRC::duration tick_diff{0};
 		
+		bool precise = false;
+		SC::time_point deadline{};
+		SC::time_point precise_start{};
+		std::chrono::nanoseconds overshoot_estimate = std::chrono::microseconds{ 200 };
+		std::chrono::nanoseconds spin_threshold = std::chrono::microseconds{ 250 };
+		
+		#if !defined(INK_FPS_LIMITER_NO_STATS)
+		FrameStatistics stats;
+		#endif
+		
 	};
 	
 }
 
+#undef INK_FPS_LIMITER_RELAX
+
 #endif
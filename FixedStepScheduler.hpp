@@ -0,0 +1,153 @@
+#ifndef INK_UTILITY_FIXED_STEP_SCHEDULER_HEADER_FILE_GUARD
+#define INK_UTILITY_FIXED_STEP_SCHEDULER_HEADER_FILE_GUARD
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <stdexcept>
+#include <vector>
+
+#include "FPS_Limiter.hpp"
+
+namespace ink {
+	
+	/**
+	 * Runs several fixed-timestep loops (e.g. physics at 240 Hz, simulation at 60 Hz, network at 20 Hz) on a single thread.
+	 * The basic, raw intended usage is as displayed:
+	 *
+	 * 	...
+	 * 	FixedStepScheduler scheduler;
+	 * 	const size_t physics = scheduler.Add(240, [&](auto dt) { StepPhysics(dt); });
+	 * 	const size_t network = scheduler.Add(20, [&](auto dt) { FlushNetwork(); }, 1);
+	 * 	while (Running) {
+	 * 		scheduler.Tick();
+	 * 		Render(scheduler.Alpha(physics));
+	 * 	}
+	 * 	...
+	 *
+	 * Each Tick() sleeps once, until the earliest deadline of any task, using FPS_Limiter's precise sleep/spin wait.
+	 * It then runs every task that has come due, as many fixed steps as needed to catch up, but at most max_steps for each task.
+	 * Steps beyond the cap are dropped and counted, rather than carried into the next tick.
+	 */
+	class FixedStepScheduler {
+		
+		public: using SC = FPS_Limiter::SC;
+		public: using Step = std::function<void(std::chrono::nanoseconds)>;
+		
+		// Per-task timing, to find out which loop is blowing its budget.
+		public: struct TaskStatistics {
+			uint64_t steps = 0;						// Steps run.
+			uint64_t dropped = 0;					// Steps skipped because of the catch-up cap.
+			std::chrono::nanoseconds max_lateness{};	// Largest delay between a step's scheduled time and its start.
+			std::chrono::nanoseconds mean_lateness{};	// Moving average of the above.
+			std::chrono::nanoseconds max_step_time{};	// Longest time a single step took to run.
+			std::chrono::nanoseconds mean_step_time{};	// Moving average of the above; compare against the task's period.
+		};
+		
+		private: struct Task {
+			Step step;
+			std::chrono::nanoseconds period;
+			size_t max_steps;
+			SC::time_point next{};
+			TaskStatistics stats;
+		};
+		
+		/**
+		 * Registers a task stepping Hz times per second. Returns its index, used by Alpha() and Statistics().
+		 * max_steps caps how many steps a single Tick() runs for this task while catching up.
+		 * Throws std::invalid_argument unless Hz is in [1, 1'000'000'000], as the period would otherwise not be positive.
+		 */
+		public: size_t
+		Add(ptrdiff_t Hz, Step step, size_t max_steps = 4)
+		{
+			if (Hz <= 0 || Hz > 1'000'000'000) throw std::invalid_argument("FixedStepScheduler: Hz must be in [1, 1'000'000'000]");
+			tasks.push_back(Task{ std::move(step), std::chrono::nanoseconds{ 1'000'000'000 / Hz }, std::max<size_t>(max_steps, 1), {}, {} });
+			if (started) tasks.back().next = SC::now();
+			return tasks.size() - 1;
+		}
+		
+		// Sleeps until the earliest task deadline, then runs every task that is due. Returns the number of steps run.
+		public: size_t
+		Tick()
+		{
+			if (tasks.empty()) return 0;
+			
+			if (!started)
+			{
+				const SC::time_point now = SC::now();
+				for (auto& task : tasks) task.next = now;
+				started = true;
+			}
+			
+			SC::time_point earliest = tasks.front().next;
+			for (auto const& task : tasks) earliest = std::min(earliest, task.next);
+			limiter.WaitUntil(earliest);
+			
+			size_t ran = 0;
+			for (auto& task : tasks)
+			{
+				size_t steps = 0;
+				for (SC::time_point now = SC::now(); task.next <= now && steps < task.max_steps; now = SC::now(), steps++)
+				{
+					Record(task.stats.max_lateness, task.stats.mean_lateness, now - task.next);
+					
+					task.step(task.period);
+					task.next += task.period;
+					
+					Record(task.stats.max_step_time, task.stats.mean_step_time, SC::now() - now);
+				}
+				task.stats.steps += steps;
+				ran += steps;
+				
+				// Drop whatever backlog the cap left behind, keeping the schedule aligned to the task's period. Only when the cap
+				// was hit: a step that merely came due since the loop stopped is left for the next tick.
+				if (steps < task.max_steps) continue;
+				const SC::time_point now = SC::now();
+				if (task.next <= now)
+				{
+					const auto behind = (now - task.next) / task.period + 1;
+					task.stats.dropped += behind;
+					task.next += task.period * behind;
+				}
+			}
+			
+			return ran;
+		}
+		
+		/**
+		 * Fraction of the task's current step that has elapsed, in [0, 1].
+		 * Used to interpolate rendering between the last two states the task produced.
+		 */
+		public: double
+		Alpha(size_t task) const
+		{
+			auto const& t = tasks[task];
+			const std::chrono::nanoseconds into = SC::now() - (t.next - t.period);
+			return std::clamp(double(into.count()) / double(t.period.count()), 0.0, 1.0);
+		}
+		
+		public: TaskStatistics const&
+		Statistics(size_t task) const
+		{ return tasks[task].stats; }
+		
+		// The limiter used for waiting; exposes the adaptive spin threshold and, unless compiled out, the sleep statistics.
+		public: FPS_Limiter const&
+		Limiter() const
+		{ return limiter; }
+		
+		private: static void
+		Record(std::chrono::nanoseconds& max, std::chrono::nanoseconds& mean, std::chrono::nanoseconds sample)
+		{
+			max = std::max(max, sample);
+			mean += (sample - mean) / 8;
+		}
+		
+		private: std::vector<Task> tasks;
+		private: FPS_Limiter limiter{ 1, true };
+		private: bool started = false;
+		
+	};
+	
+}
+
+#endif
@@ -0,0 +1,370 @@
+#ifndef INK_UTILITY_HIERARCHICAL_STATE_MACHINE_HEADER_FILE_GUARD
+#define INK_UTILITY_HIERARCHICAL_STATE_MACHINE_HEADER_FILE_GUARD
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+#include "Rebind.hpp"
+
+namespace ink::hsm {
+	
+	/**
+	 * A transition out of From (and out of every state nested in it), on Event, to To. If To is composite, the machine
+	 * goes on into its initial state, and that one's, down to a leaf.
+	 *
+	 * Action, if any, runs between the exits and the entries, as Action(context). Guard, if any, is called first, as
+	 * Guard(context) with a const context, and the transition is only taken if it returns true. Either may be a function
+	 * pointer or a captureless lambda.
+	 */
+	template<typename From, typename Event, typename To, auto Action = nullptr, auto Guard = nullptr> struct
+	Transition {
+		using from = From;
+		using event = Event;
+		using to = To;
+		static constexpr auto action = Action;
+		static constexpr auto guard = Guard;
+	};
+	
+	// Target of a transition that only runs its action: no state is left or entered, and the machine stays where it is.
+	struct Internal {};
+	
+	namespace detail {
+		
+		template<typename S> struct
+		parent_of
+		{ using type = void; };
+		
+		template<typename S> requires requires { typename S::parent; } struct
+		parent_of<S>
+		{ using type = typename S::parent; };
+		
+		template<typename S> struct
+		initial_of
+		{ using type = void; };
+		
+		template<typename S> requires requires { typename S::initial; } struct
+		initial_of<S>
+		{ using type = typename S::initial; };
+		
+		template<auto F> constexpr bool
+		given = !std::is_null_pointer_v<decltype(F)>;
+		
+		// The hierarchy, as indexes into the list of states; NONE (the number of states) stands for "no such state".
+		template<size_t N> struct
+		Tree {
+			std::array<size_t, N> parent;
+			std::array<size_t, N> initial;
+			
+			constexpr bool
+			is_leaf(size_t s) const
+			{
+				for (size_t p : parent) if (p == s) return false;
+				return true;
+			}
+			
+			// The leaf reached from s by following initial states.
+			constexpr size_t
+			resolve(size_t s) const
+			{
+				while (initial[s] != N) s = initial[s];
+				return s;
+			}
+			
+			// Whether a is s, or contains it.
+			constexpr bool
+			contains(size_t a, size_t s) const
+			{
+				for (; s != N; s = parent[s]) if (s == a) return true;
+				return false;
+			}
+		};
+		
+		// The states one transition leaves, innermost first, and enters, outermost first; and the leaf it ends in.
+		template<size_t N> struct
+		Path {
+			std::array<size_t, N> exits{};
+			std::array<size_t, N> entries{};
+			size_t exit_count = 0;
+			size_t entry_count = 0;
+			size_t target = 0;
+		};
+		
+		/**
+		 * The path of a transition declared on from, to to, taken while in leaf. Every state below the innermost state that
+		 * strictly contains both from and to is left, then entered again on the way down: a transition from a state to itself
+		 * or to a state nested in it leaves and re-enters it.
+		 */
+		template<size_t N> constexpr Path<N>
+		path(Tree<N> const& tree, size_t leaf, size_t from, size_t to)
+		{
+			Path<N> out;
+			out.target = tree.resolve(to);
+			
+			size_t domain = tree.parent[to];
+			while (domain != N && !tree.contains(domain, tree.parent[from])) domain = tree.parent[domain];
+			
+			for (size_t s = leaf; s != domain; s = tree.parent[s]) out.exits[out.exit_count++] = s;
+			for (size_t s = out.target; s != domain; s = tree.parent[s]) out.entries[out.entry_count++] = s;
+			for (size_t i = 0; i < out.entry_count / 2; i++) std::swap(out.entries[i], out.entries[out.entry_count - 1 - i]);
+			return out;
+		}
+		
+	}
+	
+	/**
+	 * A hierarchical state machine, described entirely by types: its states and events as rebind::type_lists, and its
+	 * transitions as a type_list of hsm::Transition. Nesting is declared on the states themselves, with a "parent" alias;
+	 * a state with children must name the one it starts in with an "initial" alias. Any state may have static entry and
+	 * exit functions, taking a Context&.
+	 *
+	 * 	struct Alive		{ using initial = Idle; };
+	 * 	struct Idle			{ using parent = Alive; };
+	 * 	struct Moving		{ using parent = Alive; using initial = Walk; static void entry(Actor& a) { a.speed = 1; } };
+	 * 	struct Walk			{ using parent = Moving; };
+	 * 	struct Run			{ using parent = Moving; };
+	 * 	struct Dead			{};
+	 *
+	 * 	using Machine = ink::hsm::StateMachine<Actor,
+	 * 		ink::rebind::type_list<Alive, Idle, Moving, Walk, Run, Dead>,
+	 * 		ink::rebind::type_list<Go, Faster, Stop, Hit>,
+	 * 		ink::rebind::type_list<
+	 * 			ink::hsm::Transition<Idle, Go, Moving>,
+	 * 			ink::hsm::Transition<Walk, Faster, Run, &Boost>,
+	 * 			ink::hsm::Transition<Moving, Stop, Idle>,
+	 * 			ink::hsm::Transition<Alive, Hit, Dead, nullptr, &Fatal>,	// Only while Fatal(actor) is true...
+	 * 			ink::hsm::Transition<Alive, Hit, ink::hsm::Internal, &Hurt>	// ...and otherwise, Hurt(actor).
+	 * 		>>;
+	 *
+	 * 	Machine machine;
+	 * 	machine.Start(actor);					// Enters Alive, then Idle.
+	 * 	machine.Dispatch<Go>(actor);			// Idle -> Walk, through Moving::entry.
+	 * 	if (machine.In<Moving>()) ...
+	 *
+	 * The machine is always in a leaf. An event is handled by the transitions of the leaf first, then those of its parent,
+	 * and so on outwards; within a state, in the order they are listed, stopping at the first whose guard passes. All of
+	 * this is resolved at compile time, for every leaf and event: each pair gets one generated function that checks its
+	 * candidates' guards in turn and runs the exits, action and entries of the chosen one as direct calls, and the pairs
+	 * are laid out in a dense constexpr [leaf][event] table of (target, function). A dispatch is one indexed load and one
+	 * indirect call; an event a leaf does not handle calls a function that does nothing.
+	 *
+	 * Events carry no data of their own; whatever an action needs goes through the context.
+	 */
+	template<typename Context, typename States, typename Events, typename Transitions>
+	class StateMachine;
+	
+	template<typename Context, typename... S, typename... E, typename... T>
+	class StateMachine<Context, rebind::detail::type_list_impl<S...>, rebind::detail::type_list_impl<E...>, rebind::detail::type_list_impl<T...>> {
+		
+		private: using StateList = rebind::type_list<S...>;
+		private: using EventList = rebind::type_list<E...>;
+		
+		public: static constexpr size_t
+		STATES = sizeof...(S);
+		
+		public: static constexpr size_t
+		EVENTS = sizeof...(E);
+		
+		static_assert(STATES > 0 && EVENTS > 0, "A state machine needs at least one state and one event");
+		static_assert(rebind::size_of<rebind::unique<StateList>>::value == STATES, "Every state must be listed once");
+		static_assert(rebind::size_of<rebind::unique<EventList>>::value == EVENTS, "Every event must be listed once");
+		static_assert(((std::is_void_v<typename detail::parent_of<S>::type> || StateList::template contains<typename detail::parent_of<S>::type>) && ...),
+			"Every parent must be one of the states");
+		static_assert(((StateList::template contains<typename T::from> && EventList::template contains<typename T::event>
+			&& (std::is_same_v<typename T::to, Internal> || StateList::template contains<typename T::to>)) && ...),
+			"Every transition must go from one of the states, on one of the events, to one of the states or Internal");
+		
+		private: static constexpr size_t
+		NONE = STATES;
+		
+		private: template<typename X> static constexpr size_t
+		index_of = StateList::template index_of<X>;	// NONE for void, which is not in the list.
+		
+		private: static constexpr detail::Tree<STATES>
+		TREE = { { index_of<typename detail::parent_of<S>::type>... }, { index_of<typename detail::initial_of<S>::type>... } };
+		
+		static_assert([] {
+			for (size_t s = 0; s < STATES; s++)
+			{
+				if (TREE.is_leaf(s) != (TREE.initial[s] == NONE)) return false;
+				if (TREE.initial[s] != NONE && TREE.parent[TREE.initial[s]] != s) return false;
+			}
+			return true;
+		}(), "Every state with children must name one of them as its initial state, and only those may");
+		
+		private: static constexpr size_t
+		LEAVES = (size_t(TREE.is_leaf(StateList::template index_of<S>)) + ...);
+		
+		// Leaves are numbered in the order of the states; the machine holds the number of the one it is in.
+		public: using Index = uint32_t;
+		
+		private: static constexpr std::array<size_t, LEAVES>
+		LEAF_STATE = [] {
+			std::array<size_t, LEAVES> out{};
+			for (size_t s = 0, l = 0; s < STATES; s++) if (TREE.is_leaf(s)) out[l++] = s;
+			return out;
+		}();
+		
+		private: static constexpr std::array<Index, STATES>
+		STATE_LEAF = [] {
+			std::array<Index, STATES> out{};
+			for (size_t l = 0; l < LEAVES; l++) out[LEAF_STATE[l]] = Index(l);
+			return out;
+		}();
+		
+		private: static constexpr std::array<size_t, sizeof...(T)>
+		FROM = { index_of<typename T::from>... };
+		
+		private: static constexpr std::array<size_t, sizeof...(T)>
+		EVENT = { EventList::template index_of<typename T::event>... };
+		
+		private: static constexpr std::array<bool, sizeof...(T)>
+		GUARDED = { detail::given<T::guard>... };
+		
+		// The transitions that may handle event in leaf, in the order they are tried; none past the first without a guard.
+		private: struct Candidates {
+			std::array<size_t, sizeof...(T) + 1> transitions{};
+			size_t count = 0;
+		};
+		
+		private: static constexpr Candidates
+		candidates(size_t leaf, size_t event)
+		{
+			Candidates out;
+			for (size_t s = LEAF_STATE[leaf]; s != NONE; s = TREE.parent[s])
+			{
+				for (size_t t = 0; t < sizeof...(T); t++)
+				{
+					if (FROM[t] != s || EVENT[t] != event) continue;
+					out.transitions[out.count++] = t;
+					if (!GUARDED[t]) return out;
+				}
+			}
+			return out;
+		}
+		
+		private: template<size_t State> static void
+		Exit(Context& context)
+		{
+			using X = rebind::detail::nth_type<State, S...>;
+			if constexpr (requires { X::exit(context); }) X::exit(context);
+		}
+		
+		private: template<size_t State> static void
+		Enter(Context& context)
+		{
+			using X = rebind::detail::nth_type<State, S...>;
+			if constexpr (requires { X::entry(context); }) X::entry(context);
+		}
+		
+		// Takes transition Tr while in Leaf, unless its guard fails.
+		private: template<size_t Leaf, size_t Tr> static bool
+		Take(Context& context, Index& target)
+		{
+			using X = rebind::detail::nth_type<Tr, T...>;
+			if constexpr (detail::given<X::guard>) if (!X::guard(std::as_const(context))) return false;
+			
+			if constexpr (std::is_same_v<typename X::to, Internal>)
+			{
+				if constexpr (detail::given<X::action>) X::action(context);
+				target = Index(Leaf);
+			}
+			else
+			{
+				static constexpr detail::Path<STATES> PATH = detail::path(TREE, LEAF_STATE[Leaf], FROM[Tr], index_of<typename X::to>);
+				[&]<size_t... I>(std::index_sequence<I...>) { (Exit<PATH.exits[I]>(context), ...); }(std::make_index_sequence<PATH.exit_count>{});
+				if constexpr (detail::given<X::action>) X::action(context);
+				[&]<size_t... I>(std::index_sequence<I...>) { (Enter<PATH.entries[I]>(context), ...); }(std::make_index_sequence<PATH.entry_count>{});
+				target = STATE_LEAF[PATH.target];
+			}
+			return true;
+		}
+		
+		// The whole of event Event in leaf Leaf: its candidates, tried in order, until one is taken.
+		private: template<size_t Leaf, size_t Event> static void
+		Handle(Context& context, Index& target)
+		{
+			static constexpr Candidates CANDIDATES = candidates(Leaf, Event);
+			[&]<size_t... I>(std::index_sequence<I...>) { (void)(Take<Leaf, CANDIDATES.transitions[I]>(context, target) || ...); }(std::make_index_sequence<CANDIDATES.count>{});
+		}
+		
+		private: struct Entry {
+			Index target;							// Where the machine is after the call, unless the function says otherwise.
+			void (*handle)(Context&, Index&);		// Runs the transition, and sets the target of a guarded one.
+		};
+		
+		private: static constexpr std::array<std::array<Entry, EVENTS>, LEAVES>
+		TABLE = []<size_t... I>(std::index_sequence<I...>) {
+			std::array<std::array<Entry, EVENTS>, LEAVES> out{};
+			((out[I / EVENTS][I % EVENTS] = Entry{ Index(I / EVENTS), &Handle<I / EVENTS, I % EVENTS> }), ...);
+			return out;
+		}(std::make_index_sequence<LEAVES * EVENTS>{});
+		
+		// Whether each leaf is X, or nested in it.
+		private: template<typename X> static constexpr std::array<bool, LEAVES>
+		IN = [] {
+			std::array<bool, LEAVES> out{};
+			for (size_t l = 0; l < LEAVES; l++) out[l] = TREE.contains(index_of<X>, LEAF_STATE[l]);
+			return out;
+		}();
+		
+		// Starts in the initial leaf of the first state, without entering anything; Start() does that.
+		public:
+		StateMachine():
+		current(STATE_LEAF[TREE.resolve(0)])
+		{}
+		
+		// Goes to the initial leaf of the first state, and enters every state on the way there, outermost first.
+		public: void
+		Start(Context& context)
+		{
+			static constexpr detail::Path<STATES> PATH = [] {
+				detail::Path<STATES> out;
+				out.target = TREE.resolve(0);
+				for (size_t s = out.target; s != NONE; s = TREE.parent[s]) out.entries[out.entry_count++] = s;
+				for (size_t i = 0; i < out.entry_count / 2; i++) std::swap(out.entries[i], out.entries[out.entry_count - 1 - i]);
+				return out;
+			}();
+			[&]<size_t... I>(std::index_sequence<I...>) { (Enter<PATH.entries[I]>(context), ...); }(std::make_index_sequence<PATH.entry_count>{});
+			current = STATE_LEAF[PATH.target];
+		}
+		
+		// Handles event, an index into the list of events.
+		public: void
+		Dispatch(size_t event, Context& context)
+		{
+			Entry const& entry = TABLE[current][event];
+			Index next = entry.target;
+			entry.handle(context, next);
+			current = next;
+		}
+		
+		public: template<typename Event> void
+		Dispatch(Context& context)
+		{
+			static_assert(EventList::template contains<Event>, "Not one of the events");
+			Dispatch(EventList::template index_of<Event>, context);
+		}
+		
+		// Whether the machine is in X, or in a state nested in it.
+		public: template<typename X> bool
+		In() const
+		{
+			static_assert(StateList::template contains<X>, "Not one of the states");
+			return IN<X>[current];
+		}
+		
+		// The leaf the machine is in, as an index into the list of states.
+		public: size_t
+		State() const
+		{ return LEAF_STATE[current]; }
+		
+		private: Index current;
+		
+	};
+	
+}
+
+#endif
@@ -21,6 +21,10 @@
  * 		- The return type can be changed by defining "MAKE_STATE_RETURN_TYPE" as the desired return type (this could
  * 			also be used to declare each function as a template, e.g. #define MAKE_STATE_RETURN_TYPE template<typename T> void)
  * 		
+ * 		- Parameters can be given to every function by defining "MAKE_STATE_PARAMETERS" as the parameter list, and
+ * 			"MAKE_STATE_ARGUMENTS" as the same names, separated by commas, e.g. #define MAKE_STATE_PARAMETERS Actor& actor, float dt
+ * 			and #define MAKE_STATE_ARGUMENTS actor, dt
+ * 		
  * 		- NOTE: Each function is declared, but not defined. The job of defining each function is left to the user.
  * 		
  * 		* From the above example, the functions defined would be "void Thing1(); void Thing2(); void CatInHat()".
@@ -30,8 +34,41 @@
  * 		
  * 		- The return type of this function will be the same as that of all other functions.
  * 		
+ * 		- Given "MAKE_STATE_PARAMETERS", it takes them after the State, and passes them on, e.g. "RunState(State::Thing1, actor, dt)".
+ * 		
  * 		* From the above example, running "RunState(State::Thing1)" will run "Thing1()", "RunState(State::Thing2)" -> "Thing2()", "RunState(State::CatInHat)" -> "CatInHat()".
  * 
+ * 	+ (CONDITIONALLY) If "MAKE_STATE_TABLE" is defined, "RunState" calls through a constexpr array of function pointers indexed
+ * 		by the State, rather than through a switch; and, given "MAKE_STATE_PARAMETERS", a batch function called "RunStates" alongside it.
+ * 		- "RunStates" takes a std::span<const State>, e.g. the states of every actor, and a callable that, given the index of
+ * 			one of them, returns the arguments for its call as a tuple. It runs the function of states[i] with arguments(i) for
+ * 			every i, grouped by state: first every Thing1(...), then every Thing2(...), and so on. The same indirect call then
+ * 			repeats back to back, and is predicted, where calls in actor order jump between functions at random, e.g.
+ * 			RunStates(states, [&](size_t i) { return std::forward_as_tuple(actors[i], dt); });
+ * 			(std::forward_as_tuple only suits lvalues, such as these; a temporary would be gone by the call.)
+ * 			Its return type is void; whatever the functions return is discarded. It keeps its scratch space between calls, per
+ * 			thread, so the functions must not call it in turn.
+ * 		
+ * 		- The name of this function can be changed by defining "MAKE_STATE_RUN_STATES_NAME" as the desired name of the function.
+ * 		
+ * 		- It is not defined without "MAKE_STATE_PARAMETERS": no call could then tell which of the states it is for.
+ * 		
+ * 		- Every function must have the same plain type ("MAKE_STATE_RETURN_TYPE" cannot declare templates in this mode),
+ * 			and the enum must keep its default values (0, 1, 2, ...), which it always does unless the fruit list assigns any.
+ * 		
+ * 		- <span> and <type_traits>, and for "RunStates" <tuple> and <vector>, must be included beforehand (this file may well
+ * 			be included inside a namespace).
+ * 
+ * 	+ (CONDITIONALLY) If "MAKE_STATE_TRACE" is defined, "RunState" (and so "RunStates") times and records every call it makes,
+ * 		with the state it ran and the one the same thread ran before it, through ink::StateTrace (see StateTrace.hpp): per state
+ * 		counters, and per thread rings of the latest calls, which can be dumped to a binary file and converted for chrome://tracing.
+ * 		- The dispatch itself is then generated as "RunState_Untraced" (after "MAKE_STATE_RUN_STATE_NAME"), which can be called
+ * 			directly wherever a call should go unrecorded.
+ * 		
+ * 		- StateTrace.hpp must be included beforehand, and the enum must keep its default values (0, 1, 2, ...).
+ * 		
+ * 		- Without it, nothing is recorded and nothing changes: RunState is exactly the plain switch or table above.
+ * 
  * 	+ (CONDITIONALLY) Defines a function whose name is defined by "MAKE_STATE_STRINGS", which given any State, will return a 1:1 string of the enum's name.
  * 		* From the above example, if we were to have defined MAKE_STATE_STRINGS in the form "#define MAKE_STATE_STRINGS Stringify",
  * 			then the following would compile successfully:
@@ -39,6 +76,27 @@
  * 				static_assert(Stringify(State::Thing2) == "Thing2");
  * 				static_assert(Stringify(State::CatInHat) == "CatInHat");
  * 
+ * 	+ (CONDITIONALLY) Defines a function whose name is defined by "MAKE_STATE_FROM_STRING", the reverse of the above: given any
+ * 		string, it returns the State of that name, as a std::optional<State>, or std::nullopt if no State has that name.
+ * 		- The lookup is a minimal perfect hash (see PerfectHash.hpp), built at compile time: one hash of the string, two table
+ * 			loads and one string comparison, however many states there are.
+ * 		
+ * 		- PerfectHash.hpp must be included beforehand, and the enum must keep its default values (0, 1, 2, ...).
+ * 		
+ * 		* From the above example, if we were to have defined MAKE_STATE_FROM_STRING in the form "#define MAKE_STATE_FROM_STRING FromString",
+ * 			then "FromString("CatInHat")" would return State::CatInHat, and "FromString("Cat")" std::nullopt.
+ * 
+ * 	+ Define a constant called "StateCount", the number of states, and a constexpr array called "States", of every State in order.
+ * 		- Their names are those of the enum followed by "Count" and "s", or whatever "MAKE_STATE_COUNT_NAME" and
+ * 			"MAKE_STATE_LIST_NAME" are defined as, respectively.
+ * 		
+ * 		- Neither needs any header: the count is a size_t, spelled "decltype(sizeof 0)".
+ * 		
+ * 		- Both are "static constexpr", like the function of "MAKE_STATE_STRINGS", so the header can still be included in a
+ * 			class body, where they become static members.
+ * 		
+ * 		* From the above example, "StateCount == 3", and "for (State s : States) RunState(s);" runs every state once.
+ * 
  * 
 */
 
@@ -94,7 +152,37 @@
 	#define THREE_WAY_CONCAT_impl(arg1, arg2, arg3) arg1##arg2##arg3
 	
 	
-	#define State_Function(l) MAKE_STATE_RETURN_TYPE THREE_WAY_CONCAT(MAKE_STATE_fprefix, l, MAKE_STATE_fpostfix) ();
+	#if !defined(MAKE_STATE_COUNT_NAME)
+		#define MAKE_STATE_COUNT_NAME THREE_WAY_CONCAT(MAKE_STATE_name, Count, ) // Number of states
+	#endif
+	#define State_One(l) + 1
+		static constexpr decltype(sizeof 0) MAKE_STATE_COUNT_NAME = 0 MAKE_STATE(State_One);	// A size_t, without needing <cstddef>
+	#undef State_One
+	
+	#if !defined(MAKE_STATE_LIST_NAME)
+		#define MAKE_STATE_LIST_NAME THREE_WAY_CONCAT(MAKE_STATE_name, s, ) // Every state, in order
+	#endif
+	#define State_Value(l) MAKE_STATE_name::l,
+		static constexpr MAKE_STATE_name MAKE_STATE_LIST_NAME[] = { MAKE_STATE(State_Value) };
+	#undef State_Value
+	#undef MAKE_STATE_LIST_NAME
+	
+	
+	#define MAKE_STATE_parameters // Parameters of every function, and the arguments RunState passes them on with
+	#define MAKE_STATE_arguments
+	#if defined(MAKE_STATE_PARAMETERS)
+	
+		#undef MAKE_STATE_parameters
+		#define MAKE_STATE_parameters MAKE_STATE_PARAMETERS
+		#undef MAKE_STATE_arguments
+		#define MAKE_STATE_arguments MAKE_STATE_ARGUMENTS
+		
+	#endif
+	#define MAKE_STATE_and(...) __VA_OPT__(, __VA_ARGS__) // A comma and the parameters, unless there are none
+	#define MAKE_STATE_after(list) MAKE_STATE_and(list)
+	
+	
+	#define State_Function(l) MAKE_STATE_RETURN_TYPE THREE_WAY_CONCAT(MAKE_STATE_fprefix, l, MAKE_STATE_fpostfix) (MAKE_STATE_parameters);
 		#if !defined(MAKE_STATE_RETURN_TYPE)
 			#define MAKE_STATE_RETURN_TYPE void
 		#endif
@@ -106,16 +194,99 @@
 	#if !defined(MAKE_STATE_RUN_STATE_NAME)
 		#define MAKE_STATE_RUN_STATE_NAME RunState // Function that runs the function of any given state
 	#endif
-	MAKE_STATE_RETURN_TYPE MAKE_STATE_RUN_STATE_NAME(MAKE_STATE_name state) {
-		switch (state) {
-			#define State_Case(l) case MAKE_STATE_name::l: return THREE_WAY_CONCAT(MAKE_STATE_fprefix, l, MAKE_STATE_fpostfix) (); break;
-			MAKE_STATE(State_Case)
-			#undef State_Case
-		}
-	};
+	
+	// With tracing, the dispatch below is generated under another name, and RunState times a call to it
+	#define MAKE_STATE_run_state MAKE_STATE_RUN_STATE_NAME
+	#if defined(MAKE_STATE_TRACE)
+		#undef MAKE_STATE_run_state
+		#define MAKE_STATE_run_state THREE_WAY_CONCAT(MAKE_STATE_RUN_STATE_NAME, _Untraced, )
+	#endif
+	
+	#if !defined(MAKE_STATE_TABLE)
+		MAKE_STATE_RETURN_TYPE MAKE_STATE_run_state(MAKE_STATE_name state MAKE_STATE_after(MAKE_STATE_parameters)) {
+			switch (state) {
+				#define State_Case(l) case MAKE_STATE_name::l: return THREE_WAY_CONCAT(MAKE_STATE_fprefix, l, MAKE_STATE_fpostfix) (MAKE_STATE_arguments); break;
+				MAKE_STATE(State_Case)
+				#undef State_Case
+			}
+		};
+	#else
+		// One entry per state, in enum order
+		#define State_Pointer(l) &THREE_WAY_CONCAT(MAKE_STATE_fprefix, l, MAKE_STATE_fpostfix),
+		
+		MAKE_STATE_RETURN_TYPE MAKE_STATE_run_state(MAKE_STATE_name state MAKE_STATE_after(MAKE_STATE_parameters)) {
+			static constexpr MAKE_STATE_RETURN_TYPE (*const TABLE[])(MAKE_STATE_parameters) = { MAKE_STATE(State_Pointer) };
+			return TABLE[static_cast<std::underlying_type_t<MAKE_STATE_name>>(state)](MAKE_STATE_arguments);
+		};
+	#endif
+	
+	#if defined(MAKE_STATE_TRACE)
+		#define Stringify(x) Stringify_impl(x)
+		#define Stringify_impl(x) #x
+		
+		MAKE_STATE_RETURN_TYPE MAKE_STATE_RUN_STATE_NAME(MAKE_STATE_name state MAKE_STATE_after(MAKE_STATE_parameters)) {
+			static const ink::StateTrace::Machine MACHINE = ink::StateTrace::Register<MAKE_STATE_name>(Stringify(MAKE_STATE_name), {
+				
+				#define State_String(s) Stringify(s),
+					MAKE_STATE(State_String)
+				#undef State_String
+				
+			});
+			static thread_local uint32_t previous = ink::StateTrace::NONE; // Per thread, as each thread's calls are a trace of their own
+			
+			const ink::StateTrace::Scope trace(MACHINE, previous, uint32_t(static_cast<std::underlying_type_t<MAKE_STATE_name>>(state)));
+			return MAKE_STATE_run_state(state MAKE_STATE_after(MAKE_STATE_arguments));
+		};
+		
+		#undef Stringify_impl
+		#undef Stringify
+	#endif
+	
+	#if defined(MAKE_STATE_TABLE)
+		#if !defined(MAKE_STATE_RUN_STATES_NAME)
+			#define MAKE_STATE_RUN_STATES_NAME RunStates // Function that runs the functions of many states, grouped by state
+		#endif
+		#if defined(MAKE_STATE_PARAMETERS) // Without parameters, no call could tell which of the states it is for
+			template<typename Arguments> void MAKE_STATE_RUN_STATES_NAME(std::span<const MAKE_STATE_name> states, Arguments&& arguments) {
+				static constexpr MAKE_STATE_RETURN_TYPE (*const TABLE[])(MAKE_STATE_parameters) = { MAKE_STATE(State_Pointer) };
+				constexpr decltype(sizeof 0) COUNT = sizeof(TABLE) / sizeof(TABLE[0]);
+				
+				// The indexes of states, grouped by state, counting-sort style; kept between calls, so not reentrant
+				static thread_local std::vector<decltype(sizeof 0)> order;
+				order.resize(states.size());
+				
+				decltype(sizeof 0) ends[COUNT + 1] = {}; // Counts, then where each group starts, then, once placed, where it ends
+				for (const MAKE_STATE_name state : states) ends[static_cast<std::underlying_type_t<MAKE_STATE_name>>(state) + 1]++;
+				for (decltype(sizeof 0) s = 0; s < COUNT; s++) ends[s + 1] += ends[s];
+				for (decltype(sizeof 0) i = 0; i < states.size(); i++) order[ends[static_cast<std::underlying_type_t<MAKE_STATE_name>>(states[i])]++] = i;
+				
+				decltype(sizeof 0) i = 0;
+				for (decltype(sizeof 0) s = 0; s < COUNT; s++)
+					for (; i < ends[s]; i++)
+						#if defined(MAKE_STATE_TRACE)
+							std::apply([s](auto&&... a) { MAKE_STATE_RUN_STATE_NAME(MAKE_STATE_name(s), static_cast<decltype(a)>(a)...); }, arguments(order[i])); // Traced, one call at a time
+						#else
+							std::apply(TABLE[s], arguments(order[i]));
+						#endif
+			};
+		#endif
+		#undef MAKE_STATE_RUN_STATES_NAME
+		
+		#undef State_Pointer
+		#undef MAKE_STATE_TABLE
+	#endif
+	#undef MAKE_STATE_TRACE
+	#undef MAKE_STATE_run_state
 	#undef MAKE_STATE_RETURN_TYPE
 	#undef MAKE_STATE_RUN_STATE_NAME
 	
+	#undef MAKE_STATE_after
+	#undef MAKE_STATE_and
+	#undef MAKE_STATE_arguments
+	#undef MAKE_STATE_ARGUMENTS
+	#undef MAKE_STATE_parameters
+	#undef MAKE_STATE_PARAMETERS
+	
 	
 	// Conditionally defined function that returns a string version of the declared states
 	#if defined(MAKE_STATE_STRINGS)
@@ -128,8 +299,8 @@
 				
 						MAKE_STATE(State_String)
 				
-					#define Stringify_impl(x) #x
-					#define Stringify(x) Stringify_impl(x)
+					#undef Stringify_impl
+					#undef Stringify
 				#undef State_String
 				
 			};
@@ -138,6 +309,30 @@
 		#undef MAKE_STATE_STRINGS
 	#endif
 	
+	
+	// Conditionally defined function that returns the state of a given name, if any
+	#if defined(MAKE_STATE_FROM_STRING)
+		static std::optional<MAKE_STATE_name> MAKE_STATE_FROM_STRING(std::string_view name) {
+			static constexpr ink::PerfectHash<MAKE_STATE_COUNT_NAME> HASH({
+				
+				#define State_String(s) Stringify(s),
+					#define Stringify(x) Stringify_impl(x)
+					#define Stringify_impl(x) #x
+				
+						MAKE_STATE(State_String)
+				
+					#undef Stringify_impl
+					#undef Stringify
+				#undef State_String
+				
+			});
+			if (const auto index = HASH.Find(name)) return MAKE_STATE_name(*index);
+			return std::nullopt;
+		}
+		#undef MAKE_STATE_FROM_STRING
+	#endif
+	#undef MAKE_STATE_COUNT_NAME
+	
 	#undef THREE_WAY_CONCAT_impl
 	#undef THREE_WAY_CONCAT
 	
@@ -0,0 +1,405 @@
+#ifndef INK_MULTI_ARRAY_VIEW_HEADER_FILE_GUARD
+#define INK_MULTI_ARRAY_VIEW_HEADER_FILE_GUARD
+
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#if defined(__has_include)
+	#if __has_include(<mdspan>)
+		#include <mdspan>
+	#endif
+#endif
+#if defined(__cpp_lib_mdspan)
+	#define INK_MDVIEW_MDSPAN
+#endif
+
+namespace ink::Indexing {
+	
+	// Marks an extent only known at runtime.
+	inline constexpr size_t dynamic_extent = std::dynamic_extent;
+	
+	/**
+	 * The sizes of each dimension of a multidimensional array, outermost first (the order of int[D][H][W], and of std::extents).
+	 * Each is either fixed at compile time, or given as dynamic_extent and supplied at runtime, in order, to the constructor.
+	 * Only the dynamic ones take up any room.
+	 */
+	template<size_t... Extents>
+	class extents {
+		
+		public: static constexpr size_t rank = sizeof...(Extents);
+		public: static constexpr size_t rank_dynamic = (size_t{0} + ... + size_t{Extents == dynamic_extent});
+		public: static constexpr std::array<size_t, rank> static_extents{ Extents... };
+		
+		// std::array<size_t, 0> is not an empty class, and would still take up room.
+		private: struct none {};
+		
+		private: [[no_unique_address]] std::conditional_t<rank_dynamic == 0, none, std::array<size_t, rank_dynamic>>
+		dynamic{};
+		
+		// Position of extent R among the dynamic ones.
+		private: static constexpr size_t
+		dynamic_index(size_t R)
+		{
+			size_t out = 0;
+			for (size_t r = 0; r < R; r++) out += static_extents[r] == dynamic_extent;
+			return out;
+		}
+		
+		public: constexpr
+		extents() = default;
+		
+		public: template<std::convertible_to<size_t>... Dynamic> requires (sizeof...(Dynamic) == rank_dynamic && rank_dynamic > 0) constexpr explicit
+		extents(Dynamic... dynamic_extents):
+		dynamic{ size_t(dynamic_extents)... } {}
+		
+		// Extent R; a constant whenever it is static, which is what lets the mappings divide by it cheaply.
+		public: template<size_t R> constexpr size_t
+		get() const
+		{
+			if constexpr (static_extents[R] != dynamic_extent) return static_extents[R];
+			else return dynamic[dynamic_index(R)];
+		}
+		
+		public: constexpr size_t
+		extent(size_t r) const
+		{
+			if constexpr (rank_dynamic == 0) return static_extents[r];
+			else return static_extents[r] != dynamic_extent ? static_extents[r] : dynamic[dynamic_index(r)];
+		}
+		
+		// Number of elements.
+		public: constexpr size_t
+		size() const
+		{ return [this]<size_t... R>(std::index_sequence<R...>) { return (size_t{1} * ... * get<R>()); }(std::make_index_sequence<rank>{}); }
+		
+		public: friend constexpr bool
+		operator==(extents const&, extents const&) = default;
+		
+	};
+	
+	/**
+	 * Row-major layout: the last index varies fastest, like a built-in int[D][H][W]. This is the layout TransposeToAbsolute
+	 * and TransposeFromAbsolute use, with the dimensions listed in the opposite order: extents<D, H, W> matches (W, H, D).
+	 */
+	struct layout_right {
+		
+		template<typename Extents>
+		class mapping {
+			
+			public: using extents_type = Extents;
+			public: static constexpr size_t rank = Extents::rank;
+			
+			private: [[no_unique_address]] Extents
+			_extents;
+			
+			public: constexpr
+			mapping() = default;
+			
+			public: constexpr
+			mapping(Extents const& extents):
+			_extents(extents) {}
+			
+			public: constexpr Extents const&
+			extents() const
+			{ return _extents; }
+			
+			public: constexpr size_t
+			required_span_size() const
+			{ return _extents.size(); }
+			
+			public: template<size_t R> constexpr size_t
+			stride() const
+			{ return [this]<size_t... K>(std::index_sequence<K...>) { return (size_t{1} * ... * _extents.template get<R + 1 + K>()); }(std::make_index_sequence<rank - 1 - R>{}); }
+			
+			// Horner's scheme: ((i0 * e1 + i1) * e2 + i2) ...
+			public: template<std::convertible_to<size_t>... I> requires (sizeof...(I) == rank) constexpr size_t
+			operator()(I... indices) const
+			{
+				return [&]<size_t... R>(std::index_sequence<R...>) {
+					size_t out = 0;
+					((out = out * _extents.template get<R>() + size_t(indices)), ...);
+					return out;
+				}(std::make_index_sequence<rank>{});
+			}
+			
+			// Inverse of the above. Every division and remainder is by a single extent, so static ones become multiplies and shifts.
+			public: constexpr std::array<size_t, rank>
+			coordinates(size_t i) const
+			{
+				std::array<size_t, rank> out{};
+				[&]<size_t... R>(std::index_sequence<R...>) {
+					((out[rank - 1 - R] = i % _extents.template get<rank - 1 - R>(), i /= _extents.template get<rank - 1 - R>()), ...);
+				}(std::make_index_sequence<rank>{});
+				return out;
+			}
+			
+			public: friend constexpr bool
+			operator==(mapping const&, mapping const&) = default;
+			
+		};
+		
+	};
+	
+	// Column-major layout: the first index varies fastest, like a Fortran array.
+	struct layout_left {
+		
+		template<typename Extents>
+		class mapping {
+			
+			public: using extents_type = Extents;
+			public: static constexpr size_t rank = Extents::rank;
+			
+			private: [[no_unique_address]] Extents
+			_extents;
+			
+			public: constexpr
+			mapping() = default;
+			
+			public: constexpr
+			mapping(Extents const& extents):
+			_extents(extents) {}
+			
+			public: constexpr Extents const&
+			extents() const
+			{ return _extents; }
+			
+			public: constexpr size_t
+			required_span_size() const
+			{ return _extents.size(); }
+			
+			public: template<size_t R> constexpr size_t
+			stride() const
+			{ return [this]<size_t... K>(std::index_sequence<K...>) { return (size_t{1} * ... * _extents.template get<K>()); }(std::make_index_sequence<R>{}); }
+			
+			public: template<std::convertible_to<size_t>... I> requires (sizeof...(I) == rank) constexpr size_t
+			operator()(I... indices) const
+			{
+				const std::array<size_t, rank> index{ size_t(indices)... };
+				return [&]<size_t... R>(std::index_sequence<R...>) {
+					size_t out = 0;
+					((out = out * _extents.template get<rank - 1 - R>() + index[rank - 1 - R]), ...);
+					return out;
+				}(std::make_index_sequence<rank>{});
+			}
+			
+			public: constexpr std::array<size_t, rank>
+			coordinates(size_t i) const
+			{
+				std::array<size_t, rank> out{};
+				[&]<size_t... R>(std::index_sequence<R...>) {
+					((out[R] = i % _extents.template get<R>(), i /= _extents.template get<R>()), ...);
+				}(std::make_index_sequence<rank>{});
+				return out;
+			}
+			
+			public: friend constexpr bool
+			operator==(mapping const&, mapping const&) = default;
+			
+		};
+		
+	};
+	
+	/**
+	 * Arbitrary strides, in elements, one per dimension; e.g. a sub-box of a larger array, or every other row.
+	 * There is no coordinates(): strides need not describe a bijection.
+	 */
+	struct layout_stride {
+		
+		template<typename Extents>
+		class mapping {
+			
+			public: using extents_type = Extents;
+			public: static constexpr size_t rank = Extents::rank;
+			
+			private: [[no_unique_address]] Extents
+			_extents;
+			
+			private: std::array<size_t, rank>
+			_strides{};
+			
+			public: constexpr
+			mapping() = default;
+			
+			public: constexpr
+			mapping(Extents const& extents, std::array<size_t, rank> const& strides):
+			_extents(extents), _strides(strides) {}
+			
+			// Same strides as another layout's mapping over the same extents.
+			public: template<typename Mapping> requires std::same_as<typename Mapping::extents_type, Extents> constexpr explicit
+			mapping(Mapping const& other):
+			_extents(other.extents())
+			{ [&]<size_t... R>(std::index_sequence<R...>) { ((_strides[R] = other.template stride<R>()), ...); }(std::make_index_sequence<rank>{}); }
+			
+			public: constexpr Extents const&
+			extents() const
+			{ return _extents; }
+			
+			public: constexpr std::array<size_t, rank> const&
+			strides() const
+			{ return _strides; }
+			
+			public: template<size_t R> constexpr size_t
+			stride() const
+			{ return _strides[R]; }
+			
+			// One past the furthest element reachable, or 0 when any extent is 0.
+			public: constexpr size_t
+			required_span_size() const
+			{
+				size_t out = 1;
+				for (size_t r = 0; r < rank; r++)
+				{
+					if (_extents.extent(r) == 0) return 0;
+					out += (_extents.extent(r) - 1) * _strides[r];
+				}
+				return out;
+			}
+			
+			public: template<std::convertible_to<size_t>... I> requires (sizeof...(I) == rank) constexpr size_t
+			operator()(I... indices) const
+			{
+				return [&]<size_t... R>(std::index_sequence<R...>) {
+					return (size_t{0} + ... + (size_t(indices) * _strides[R]));
+				}(std::make_index_sequence<rank>{});
+			}
+			
+			public: friend constexpr bool
+			operator==(mapping const&, mapping const&) = default;
+			
+		};
+		
+	};
+	
+	/**
+	 * Non-owning multidimensional view over contiguous memory; a small std::mdspan, usable where <mdspan> is not available,
+	 * and convertible to and from it where it is. Extents may be static, or dynamic_extent and given at construction:
+	 *
+	 * 	float grid[64 * 64 * 64];
+	 * 	ink::Indexing::mdview<float, 64, 64, 64> v(grid);					// v(z, y, x) == grid[(z * 64 + y) * 64 + x]
+	 * 	ink::Indexing::mdview<float, dynamic_extent, 64, 64> d(grid, 64);	// Same, with the depth only known at runtime.
+	 * 	auto [z, y, x] = v.coordinates(i);									// Inverse; only shifts for these extents.
+	 *
+	 * With static extents, both directions only multiply, add, and divide by constants, which the compiler turns into
+	 * multiplies and shifts; dynamic extents leave one runtime division per dimension in coordinates().
+	 */
+	template<typename T, typename Layout, size_t... Extents>
+	class basic_mdview {
+		
+		public: using element_type = T;
+		public: using extents_type = Indexing::extents<Extents...>;
+		public: using layout_type = Layout;
+		public: using mapping_type = typename Layout::template mapping<extents_type>;
+		
+		public: static constexpr size_t rank = sizeof...(Extents);
+		
+		private: T*
+		_data = nullptr;
+		
+		private: [[no_unique_address]] mapping_type
+		_mapping;
+		
+		public: constexpr
+		basic_mdview() = default;
+		
+		// Row- and column-major views, from their dynamic extents only.
+		public: template<std::convertible_to<size_t>... Dynamic> requires (sizeof...(Dynamic) == extents_type::rank_dynamic && std::constructible_from<mapping_type, extents_type>) constexpr explicit
+		basic_mdview(T* data, Dynamic... dynamic_extents):
+		_data(data), _mapping(extents_type(dynamic_extents...)) {}
+		
+		public: constexpr
+		basic_mdview(T* data, mapping_type const& mapping):
+		_data(data), _mapping(mapping) {}
+		
+		public: constexpr T*
+		data() const
+		{ return _data; }
+		
+		public: constexpr mapping_type const&
+		mapping() const
+		{ return _mapping; }
+		
+		public: constexpr extents_type const&
+		extents() const
+		{ return _mapping.extents(); }
+		
+		public: constexpr size_t
+		extent(size_t r) const
+		{ return _mapping.extents().extent(r); }
+		
+		// Number of elements in view.
+		public: constexpr size_t
+		size() const
+		{ return _mapping.extents().size(); }
+		
+		public: template<size_t R> constexpr size_t
+		stride() const
+		{ return _mapping.template stride<R>(); }
+		
+		public: template<std::convertible_to<size_t>... I> requires (sizeof...(I) == rank) constexpr T&
+		operator()(I... indices) const
+		{ return _data[_mapping(indices...)]; }
+		
+		public: constexpr T&
+		operator[](std::array<size_t, rank> const& index) const
+		{ return std::apply([this](auto... i) -> T& { return (*this)(i...); }, index); }
+		
+		// Offset of the element at the given coordinates, from data().
+		public: template<std::convertible_to<size_t>... I> requires (sizeof...(I) == rank) constexpr size_t
+		offset(I... indices) const
+		{ return _mapping(indices...); }
+		
+		// Coordinates of the element at the given offset from data(); see the mappings.
+		public: constexpr std::array<size_t, rank>
+		coordinates(size_t offset) const requires requires (mapping_type const& m) { m.coordinates(offset); }
+		{ return _mapping.coordinates(offset); }
+		
+		#if defined(INK_MDVIEW_MDSPAN)
+		
+		private: using std_layout = std::conditional_t<std::is_same_v<Layout, layout_right>, std::layout_right,
+			std::conditional_t<std::is_same_v<Layout, layout_left>, std::layout_left, std::layout_stride>>;
+		
+		public: using mdspan_type = std::mdspan<T, std::extents<size_t, Extents...>, std_layout>;
+		
+		public: constexpr
+		operator mdspan_type() const
+		{
+			const auto std_extents = [this]<size_t... R>(std::index_sequence<R...>) {
+				return std::extents<size_t, Extents...>(std::array<size_t, rank>{ extent(R)... });
+			}(std::make_index_sequence<rank>{});
+			
+			if constexpr (std::is_same_v<Layout, layout_stride>) return mdspan_type(_data, typename mdspan_type::mapping_type(std_extents, _mapping.strides()));
+			else return mdspan_type(_data, std_extents);
+		}
+		
+		public: constexpr explicit
+		basic_mdview(mdspan_type const& span):
+		_data(span.data_handle()),
+		_mapping([&]<size_t... R>(std::index_sequence<R...>) {
+			const extents_type ex = [&]<size_t... D>(std::index_sequence<D...>) {
+				// Pick out the dynamic extents, in order.
+				std::array<size_t, extents_type::rank_dynamic> dynamic{};
+				for (size_t r = 0, d = 0; r < rank; r++) if (extents_type::static_extents[r] == dynamic_extent) dynamic[d++] = span.extent(r);
+				if constexpr (sizeof...(D) == 0) return extents_type();
+				else return extents_type(dynamic[D]...);
+			}(std::make_index_sequence<extents_type::rank_dynamic>{});
+			
+			if constexpr (std::is_same_v<Layout, layout_stride>) return mapping_type(ex, { size_t(span.stride(R))... });
+			else return mapping_type(ex);
+		}(std::make_index_sequence<rank>{}))
+		{}
+		
+		#endif
+		
+	};
+	
+	template<typename T, size_t... Extents> using
+	mdview = basic_mdview<T, layout_right, Extents...>;
+	
+}
+
+#endif
@@ -1,9 +1,19 @@
 #ifndef INK_MUTLI_ARRAY_INDEXING_HEADER_FILE_GUARD
 #define INK_MUTLI_ARRAY_INDEXING_HEADER_FILE_GUARD
 
+#include <array>
 #include <cstddef>
+#include <cstdint>
 #include <concepts>
+#include <iterator>
 #include <tuple>
+#include <type_traits>
+#include <utility>
+
+#if defined(__BMI2__)
+	#include <immintrin.h>
+	#define INK_INDEXING_BMI2
+#endif
 
 namespace ink::Indexing {
 	
@@ -42,12 +52,394 @@ namespace ink::Indexing {
 	template<size_t... dimension_sizes> static constexpr auto
 	TransposeFromAbsolute(size_t i)
 	{
-		size_t factor = 1;
-		
 		auto lambda = [&](size_t dimen_size) constexpr
-		{ size_t out = (i / factor) - dimen_size * (i / (factor * dimen_size)); factor *= dimen_size; return out; };
+		{ size_t out = i % dimen_size; i /= dimen_size; return out; };
+		
+		// Braced initialization runs the lambdas in order, which they rely on; function arguments (make_tuple) are unsequenced.
+		return std::tuple<decltype(size_t(dimension_sizes))...>{ lambda(dimension_sizes)... };
+	}
+	
+	/**
+	 * One cell of a CellRange: its absolute index (as from TransposeToAbsolute), and its coordinates, in the same order as
+	 * the dimension sizes. Destructures as | auto [i, coordinates] = cell; |.
+	 */
+	template<size_t dimensions> struct
+	Cell
+	{
+		size_t absolute = 0;
+		std::array<size_t, dimensions> coordinates{};
+	};
+	
+	/**
+	 * @brief The cells of a box within a multidimensional array, visited in absolute index order (first dimension fastest),
+	 * optionally every step-th cell along each dimension. Stepping from one cell to the next adds to the first coordinate
+	 * and carries into the next ones as they wrap around, like an odometer; there is no division at all, where calling
+	 * TransposeFromAbsolute on every absolute index costs two per dimension.
+	 * 
+	 * i.e. | for (auto [i, xyz] : Cells(W, H, D)) out[i] = f(xyz[0], xyz[1], xyz[2]); |
+	 * 
+	 * A range can be cut into contiguous slices, in visiting order, to be handed out to worker threads; see slice() and chunk().
+	 * Only the first cell of each slice is found by division.
+	 */
+	template<size_t dimensions>
+	class CellRange {
+		
+		static_assert(dimensions > 0, "a CellRange needs at least one dimension");
+		
+		public: using Sizes = std::array<size_t, dimensions>;
+		
+		public: class iterator {
+			
+			friend class CellRange;
+			
+			// Cells are handed out by value, as the one kept here changes in place on every step. That makes this a C++17 input
+			// iterator only, though it is multi-pass: a C++20 forward iterator, like std::views::iota's.
+			public: using iterator_concept = std::forward_iterator_tag;
+			public: using iterator_category = std::input_iterator_tag;
+			public: using value_type = Cell<dimensions>;
+			public: using difference_type = std::ptrdiff_t;
+			public: using pointer = value_type const*;
+			public: using reference = value_type;
+			
+			private: CellRange const*
+			range = nullptr;
+			
+			private: value_type
+			cell{};
+			
+			// Position in visiting order; all iterator comparisons go by this alone.
+			private: size_t
+			ordinal = 0;
+			
+			// The range's step and limit along the first dimension. Its jump is the step itself, as its factor is 1.
+			private: size_t
+			step = 0, limit = 0;
+			
+			public: constexpr
+			iterator() = default;
+			
+			private: constexpr
+			iterator(CellRange const* range, size_t ordinal):
+			range(range), ordinal(ordinal), step(range->step[0]), limit(range->limit[0]) {}
+			
+			public: constexpr reference
+			operator*() const
+			{ return cell; }
+			
+			public: constexpr pointer
+			operator->() const
+			{ return &cell; }
+			
+			public: constexpr iterator&
+			operator++()
+			{
+				++ordinal;
+				
+				// The first dimension is stepped from copies kept here, so that the common case never goes back to the range.
+				cell.coordinates[0] += step;
+				cell.absolute += step;
+				if (cell.coordinates[0] < limit) return *this;
+				cell.coordinates[0] = range->first[0];
+				cell.absolute -= range->rewind[0];
+				
+				for (size_t d = 1; d < dimensions; d++)
+				{
+					cell.coordinates[d] += range->step[d];
+					cell.absolute += range->jump[d];
+					if (cell.coordinates[d] < range->limit[d]) break;
+					
+					// Wrapped around; rewind this dimension, and carry into the next.
+					cell.coordinates[d] = range->first[d];
+					cell.absolute -= range->rewind[d];
+				}
+				return *this;
+			}
+			
+			public: constexpr iterator
+			operator++(int)
+			{ auto copy = *this; ++*this; return copy; }
+			
+			public: friend constexpr bool
+			operator==(iterator const& lhs, iterator const& rhs)
+			{ return lhs.ordinal == rhs.ordinal; }
+			
+		};
+		
+		private: Sizes
+		first{}, step{}, counts{}, limit{}, factors{}, jump{}, rewind{};
 		
-		return std::make_tuple( lambda(dimension_sizes)... );
+		// Slice of the visiting order covered, [begin_ordinal, end_ordinal).
+		private: size_t
+		begin_ordinal = 0, end_ordinal = 0;
+		
+		public: constexpr
+		CellRange() = default;
+		
+		/**
+		 * @param dimension_sizes Sizes of the whole array, as for TransposeToAbsolute.
+		 * @param first Coordinates of the first corner of the box.
+		 * @param last Coordinates one past the opposite corner of the box.
+		 * @param step Distance between visited cells, along each dimension; 1 visits every cell.
+		 */
+		public: constexpr
+		CellRange(Sizes const& dimension_sizes, Sizes const& first, Sizes const& last, Sizes const& step):
+		first(first), step(step)
+		{
+			size_t factor = 1;
+			end_ordinal = 1;
+			for (size_t d = 0; d < dimensions; d++)
+			{
+				counts[d] = last[d] > first[d] ? (last[d] - first[d] + step[d] - 1) / step[d] : 0;
+				limit[d] = first[d] + counts[d] * step[d];
+				factors[d] = factor;
+				jump[d] = step[d] * factor;
+				rewind[d] = counts[d] * jump[d];
+				factor *= dimension_sizes[d];
+				end_ordinal *= counts[d];
+			}
+		}
+		
+		// Every cell of the box [first, last).
+		public: constexpr
+		CellRange(Sizes const& dimension_sizes, Sizes const& first, Sizes const& last):
+		CellRange(dimension_sizes, first, last, filled(1)) {}
+		
+		// Every cell of the array.
+		public: constexpr explicit
+		CellRange(Sizes const& dimension_sizes):
+		CellRange(dimension_sizes, filled(0), dimension_sizes, filled(1)) {}
+		
+		public: constexpr size_t
+		size() const
+		{ return end_ordinal - begin_ordinal; }
+		
+		public: constexpr bool
+		empty() const
+		{ return end_ordinal == begin_ordinal; }
+		
+		// Number of cells visited along each dimension.
+		public: constexpr Sizes const&
+		extents() const
+		{ return counts; }
+		
+		public: constexpr iterator
+		begin() const
+		{ return seek(begin_ordinal); }
+		
+		public: constexpr iterator
+		end() const
+		{ return iterator(this, end_ordinal); }
+		
+		// The cells from the first-th to before the last-th of this range, in visiting order.
+		public: constexpr CellRange
+		slice(size_t first_cell, size_t last_cell) const
+		{
+			CellRange out = *this;
+			out.begin_ordinal = begin_ordinal + first_cell;
+			out.end_ordinal = begin_ordinal + last_cell;
+			return out;
+		}
+		
+		// The index-th of count slices of (nearly) equal size, which together cover this range.
+		public: constexpr CellRange
+		chunk(size_t index, size_t count) const
+		{ return slice(size() * index / count, size() * (index + 1) / count); }
+		
+		// Iterator to the ordinal-th cell in visiting order; one division per dimension.
+		private: constexpr iterator
+		seek(size_t ordinal) const
+		{
+			iterator out(this, ordinal);
+			if (ordinal == end_ordinal) return out;
+			for (size_t d = 0; d < dimensions; d++)
+			{
+				const size_t k = ordinal % counts[d];
+				ordinal /= counts[d];
+				out.cell.coordinates[d] = first[d] + k * step[d];
+				out.cell.absolute += out.cell.coordinates[d] * factors[d];
+			}
+			return out;
+		}
+		
+		private: static constexpr Sizes
+		filled(size_t value)
+		{ Sizes out; out.fill(value); return out; }
+		
+	};
+	
+	/**
+	 *	@param dimension_sizes As for TransposeToAbsolute.
+	 *	@return Every cell of the array, in absolute index order; see CellRange.
+	 */
+	template<typename... i> requires(sizeof...(i) > 0 && (std::convertible_to<i,size_t>&&...)) static constexpr CellRange<sizeof...(i)>
+	Cells(i... dimension_sizes)
+	{ return CellRange<sizeof...(i)>({ size_t(dimension_sizes)... }); }
+	
+	/**
+	 * @brief Like TransposeToAbsolute, but for an array stored as a grid of tiles: each tile_sizes[0] x tile_sizes[1] x ...
+	 * block of cells is contiguous, and the tiles themselves are laid out one after the other, in the same order as cells
+	 * are by TransposeToAbsolute. Cells that are close in any direction then tend to share a cache line or a page,
+	 * which a column walk over a plain row-major array never does.
+	 * 
+	 * i.e. with 4x4 tiles over a 16x16 array, TransposeToTiled<4,4>(16,16)(x,y) is the cell's position in the tile
+	 * (x%4 + 4*(y%4)), plus 16 times the position of the tile ((x/4) + 4*(y/4)).
+	 * 
+	 * @tparam tile_sizes Size of a tile in each dimension, in the same order as dimension_sizes. Powers of two turn every
+	 * division and remainder into a shift and a mask.
+	 * 
+	 * @param dimension_sizes As for TransposeToAbsolute; each must be a multiple of the matching tile size.
+	 * 
+	 * @return A lambda taking one index per dimension, as for TransposeToAbsolute.
+	 */
+	template<size_t... tile_sizes, typename... i> requires(sizeof...(tile_sizes) == sizeof...(i) && (std::convertible_to<i,size_t>&&...)) static constexpr auto
+	TransposeToTiled(i... dimension_sizes)
+	{
+		return [=](i... indexes) constexpr {
+			size_t	inner = 0,
+					inner_factor = 1,
+					tile = 0,
+					tile_factor = 1;
+			((	inner += (indexes % tile_sizes) * inner_factor	,	inner_factor *= tile_sizes	,
+				tile += (indexes / tile_sizes) * tile_factor	,	tile_factor *= dimension_sizes / tile_sizes	),...);
+			return tile * inner_factor + inner;
+		};
+	}
+	
+	/**
+	 *	@param dimension_sizes As for TransposeToTiled.
+	 *	@return The inverse of TransposeToTiled<tile_sizes...>(dimension_sizes...): a lambda taking an absolute index,
+	 *	and returning a tuple of indexes in the same order as dimension_sizes. Only the tile position needs a runtime
+	 *	division per dimension; the position inside the tile is divided by constants.
+	 */
+	template<size_t... tile_sizes, typename... i> requires(sizeof...(tile_sizes) == sizeof...(i) && (std::convertible_to<i,size_t>&&...)) static constexpr auto
+	TransposeFromTiled(i... dimension_sizes)
+	{
+		return [=](size_t index) constexpr {
+			constexpr size_t volume = (size_t{1} * ... * tile_sizes);
+			size_t	inner = index % volume,
+					tile = index / volume;
+			
+			auto lambda = [&](size_t tile_size, size_t tiles) constexpr
+			{ size_t out = (tile % tiles) * tile_size + inner % tile_size; tile /= tiles; inner /= tile_size; return out; };
+			
+			// Braced initialization runs the lambdas in order, which they rely on.
+			return std::tuple<decltype(size_t(tile_sizes))...>{ lambda(tile_sizes, size_t(dimension_sizes) / tile_sizes)... };
+		};
+	}
+	
+	namespace detail {
+		
+		// Every D-th bit, from bit 0; where the bits of one coordinate go in a D-dimensional Morton code.
+		template<size_t D> inline constexpr uint64_t
+		morton_mask = [] { uint64_t out = 0; for (size_t b = 0; b < 64; b += D) out |= uint64_t(1) << b; return out; }();
+		
+		// Moves bit b of x to bit b*D. The magic-number sequences are the usual ones for 2 and 3 dimensions.
+		template<size_t D> constexpr uint64_t
+		morton_spread(uint64_t x)
+		{
+			#if defined(INK_INDEXING_BMI2)
+			if (!std::is_constant_evaluated()) return _pdep_u64(x, morton_mask<D>);
+			#endif
+			
+			if constexpr (D == 1) return x;
+			else if constexpr (D == 2)
+			{
+				x &= 0x00000000FFFFFFFF;
+				x = (x | x << 16) & 0x0000FFFF0000FFFF;
+				x = (x | x << 8) & 0x00FF00FF00FF00FF;
+				x = (x | x << 4) & 0x0F0F0F0F0F0F0F0F;
+				x = (x | x << 2) & 0x3333333333333333;
+				x = (x | x << 1) & 0x5555555555555555;
+				return x;
+			}
+			else if constexpr (D == 3)
+			{
+				x &= 0x00000000001FFFFF;
+				x = (x | x << 32) & 0x001F00000000FFFF;
+				x = (x | x << 16) & 0x001F0000FF0000FF;
+				x = (x | x << 8) & 0x100F00F00F00F00F;
+				x = (x | x << 4) & 0x10C30C30C30C30C3;
+				x = (x | x << 2) & 0x1249249249249249;
+				return x;
+			}
+			else
+			{
+				uint64_t out = 0;
+				for (size_t b = 0; b * D < 64; b++) out |= ((x >> b) & 1) << (b * D);
+				return out;
+			}
+		}
+		
+		// Inverse of morton_spread: gathers bits 0, D, 2D... of x into the low bits.
+		template<size_t D> constexpr uint64_t
+		morton_compact(uint64_t x)
+		{
+			#if defined(INK_INDEXING_BMI2)
+			if (!std::is_constant_evaluated()) return _pext_u64(x, morton_mask<D>);
+			#endif
+			
+			if constexpr (D == 1) return x;
+			else if constexpr (D == 2)
+			{
+				x &= 0x5555555555555555;
+				x = (x ^ (x >> 1)) & 0x3333333333333333;
+				x = (x ^ (x >> 2)) & 0x0F0F0F0F0F0F0F0F;
+				x = (x ^ (x >> 4)) & 0x00FF00FF00FF00FF;
+				x = (x ^ (x >> 8)) & 0x0000FFFF0000FFFF;
+				x = (x ^ (x >> 16)) & 0x00000000FFFFFFFF;
+				return x;
+			}
+			else if constexpr (D == 3)
+			{
+				x &= 0x1249249249249249;
+				x = (x ^ (x >> 2)) & 0x10C30C30C30C30C3;
+				x = (x ^ (x >> 4)) & 0x100F00F00F00F00F;
+				x = (x ^ (x >> 8)) & 0x001F0000FF0000FF;
+				x = (x ^ (x >> 16)) & 0x001F00000000FFFF;
+				x = (x ^ (x >> 32)) & 0x00000000001FFFFF;
+				return x;
+			}
+			else
+			{
+				uint64_t out = 0;
+				for (size_t b = 0; b * D < 64; b++) out |= ((x >> (b * D)) & 1) << b;
+				return out;
+			}
+		}
+		
+	}
+	
+	/**
+	 * @brief Generates an absolute index from multiple dimensional indexes along a Morton (Z-order) curve: the bits of the
+	 * indexes are interleaved, the first index supplying the lowest bit. Every aligned 2^k x 2^k x ... block of cells is
+	 * then contiguous, at every k at once, without picking a tile size.
+	 * 
+	 * Uses BMI2's pdep when compiled for it (-mbmi2, or -march=haswell and later), and shifts and masks otherwise.
+	 * NOTE: AMD CPUs before Zen 3 run pdep/pext in microcode, far slower than the fallback; leave BMI2 off when targeting them.
+	 * 
+	 * @param indexes One index per dimension, in the same order as for TransposeToAbsolute. Each must fit in 64/D bits.
+	 * The array needs room for the next power of two of its largest dimension, raised to the number of dimensions.
+	 */
+	template<typename... i> requires(sizeof...(i) > 0 && (std::convertible_to<i,size_t>&&...)) static constexpr size_t
+	TransposeToMorton(i... indexes)
+	{
+		constexpr size_t D = sizeof...(i);
+		size_t out = 0, shift = 0;
+		((	out |= size_t(detail::morton_spread<D>(uint64_t(indexes))) << shift++	),...);
+		return out;
+	}
+	
+	/**
+	 *	@tparam dimensions The number of indexes the absolute index was made from.
+	 *	@param i The index of interest.
+	 *	@return The inverse of TransposeToMorton: a tuple of indexes, in the same order as TransposeToMorton takes them.
+	 */
+	template<size_t dimensions> static constexpr auto
+	TransposeFromMorton(size_t i)
+	{
+		return [&]<size_t... d>(std::index_sequence<d...>) constexpr {
+			return std::make_tuple( size_t(detail::morton_compact<dimensions>(uint64_t(i) >> d))... );
+		}(std::make_index_sequence<dimensions>{});
 	}
 	
 }
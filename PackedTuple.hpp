@@ -0,0 +1,166 @@
+#ifndef INK_UTILITY_PACKED_TUPLE_HEADER_FILE_GUARD
+#define INK_UTILITY_PACKED_TUPLE_HEADER_FILE_GUARD
+
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "Rebind.hpp"
+
+namespace ink {
+	
+	namespace detail {
+		
+		/* Helpers */
+		
+		// One element, as stored. Keyed by its logical index, so that duplicate types stay distinct bases,
+		// and so that get<I> can find it without knowing where the layout put it.
+		template<size_t I, typename T> struct
+		packed_leaf
+		{
+			[[no_unique_address]] T value{};
+			
+			constexpr
+			packed_leaf() = default;
+			
+			template<typename Arg> constexpr
+			packed_leaf(std::in_place_t, Arg&& arg):
+			value(std::forward<Arg>(arg))
+			{}
+		};
+		
+		// An element's logical index and type, as it goes through the sort.
+		template<size_t I, typename T> struct
+		packed_slot
+		{ using type = T; };
+		
+		template<typename A, typename B> struct
+		more_aligned
+		{ static constexpr bool value = alignof(typename A::type) > alignof(typename B::type); };
+		
+		/**
+		 * Logical indices of Ts, in the order they are laid out: by descending alignment, and in declaration order
+		 * among equal alignments. With every alignment a power of two, that leaves no padding between members;
+		 * only the tail padding needed to round the whole up to the largest alignment remains.
+		 */
+		template<typename Sequence, typename... Ts> struct
+		packed_order_impl;
+		
+		template<size_t... I, typename... Ts> struct
+		packed_order_impl<std::index_sequence<I...>, Ts...>
+		{
+			private:
+			template<typename List> struct indices;
+			template<size_t... S, typename... types> struct
+			indices<rebind::detail::type_list_impl<packed_slot<S, types>...>>
+			{ using type = std::index_sequence<S...>; };
+			
+			public:
+			using type = rebind::detail::Invoke< indices<
+				typename rebind::sort< rebind::detail::type_list_impl<packed_slot<I, Ts>...> >::template by<more_aligned>
+			> >;
+		};
+		
+		template<typename... Ts> using
+		packed_order = rebind::detail::Invoke< packed_order_impl<std::index_sequence_for<Ts...>, Ts...> >;
+		
+		// The leaves are bases in storage order; base subobjects are laid out in declaration order by every mainstream ABI.
+		template<typename Order, typename... Ts> struct
+		packed_storage;
+		
+		template<size_t... S, typename... Ts> struct
+		packed_storage<std::index_sequence<S...>, Ts...>: packed_leaf<S, rebind::detail::nth_type<S, Ts...>>...
+		{
+			constexpr
+			packed_storage() = default;
+			
+			// Arguments come in logical order, and are handed out to the leaves in storage order.
+			template<typename... Args> constexpr
+			packed_storage(std::tuple<Args...>&& args):
+			packed_leaf<S, rebind::detail::nth_type<S, Ts...>>(std::in_place, std::get<S>(std::move(args)))...
+			{}
+		};
+		
+	}
+	
+	/**
+	 * A tuple whose members are laid out by descending alignment instead of declaration order, to cut the padding between them.
+	 * It is otherwise used in logical order, just like std::tuple: get<I>, tuple_size, tuple_element, structured bindings
+	 * and construction all follow the order in which Ts are given. It can be built straight out of a type list:
+	 *
+	 * 	using Particle = ink::rebind::type_list<bool, double, char, float, double, short>;
+	 * 	using Row = Particle::unpack_into<ink::packed_tuple>;
+	 * 	static_assert(sizeof(Row) == 24); // std::tuple, or a struct in declaration order, takes 40.
+	 * 	Row row{ true, 1.0, 'a', 2.0F, 3.0, short(4) };
+	 * 	auto& [alive, x, tag, weight, y, layer] = row;
+	 *
+	 * storage_order lists the logical indices in the order the members sit in memory.
+	 */
+	template<typename... Ts>
+	class packed_tuple {
+		
+		template<size_t I, typename... Us> friend constexpr auto&
+		get(packed_tuple<Us...>&) noexcept;
+		
+		template<size_t I, typename... Us> friend constexpr auto const&
+		get(packed_tuple<Us...> const&) noexcept;
+		
+		public: using storage_order = rebind::pack< detail::packed_order<Ts...> >;
+		
+		private: detail::packed_storage<detail::packed_order<Ts...>, Ts...>
+		storage;
+		
+		public: constexpr
+		packed_tuple() = default;
+		
+		public: template<typename... Args> requires (sizeof...(Args) == sizeof...(Ts) && sizeof...(Ts) > 0 && (std::is_constructible_v<Ts, Args&&> && ...)) constexpr
+		packed_tuple(Args&&... args):
+		storage(std::forward_as_tuple(std::forward<Args>(args)...))
+		{}
+		
+		public: template<typename... Us> requires (sizeof...(Us) == sizeof...(Ts) && (std::is_constructible_v<Ts, Us const&> && ...)) constexpr explicit
+		packed_tuple(std::tuple<Us...> const& tuple):
+		packed_tuple(std::make_from_tuple<packed_tuple>(tuple))
+		{}
+		
+		// Converts to a std::tuple in logical order.
+		public: template<typename... Us> requires (sizeof...(Us) == sizeof...(Ts) && (std::is_constructible_v<Us, Ts const&> && ...)) constexpr explicit
+		operator std::tuple<Us...>() const
+		{ return [&]<size_t... I>(std::index_sequence<I...>) { return std::tuple<Us...>(get<I>(*this)...); }(std::index_sequence_for<Ts...>{}); }
+		
+		// Compares member by member, in logical order.
+		public: friend constexpr bool
+		operator==(packed_tuple const& lhs, packed_tuple const& rhs)
+		{ return [&]<size_t... I>(std::index_sequence<I...>) { return ((get<I>(lhs) == get<I>(rhs)) && ...); }(std::index_sequence_for<Ts...>{}); }
+		
+	};
+	
+	template<size_t I, typename... Ts> constexpr auto&
+	get(packed_tuple<Ts...>& tuple) noexcept
+	{ return static_cast< detail::packed_leaf<I, rebind::detail::nth_type<I, Ts...>>& >(tuple.storage).value; }
+	
+	template<size_t I, typename... Ts> constexpr auto const&
+	get(packed_tuple<Ts...> const& tuple) noexcept
+	{ return static_cast< detail::packed_leaf<I, rebind::detail::nth_type<I, Ts...>> const& >(tuple.storage).value; }
+	
+	template<size_t I, typename... Ts> constexpr auto&&
+	get(packed_tuple<Ts...>&& tuple) noexcept
+	{ return std::move(get<I>(tuple)); }
+	
+	template<size_t I, typename... Ts> constexpr auto const&&
+	get(packed_tuple<Ts...> const&& tuple) noexcept
+	{ return std::move(get<I>(tuple)); }
+	
+}
+
+// Structured bindings and std::apply-style generic code.
+template<typename... Ts> struct
+std::tuple_size<ink::packed_tuple<Ts...>>: std::integral_constant<size_t, sizeof...(Ts)>
+{};
+
+template<size_t I, typename... Ts> struct
+std::tuple_element<I, ink::packed_tuple<Ts...>>
+{ using type = ink::rebind::detail::nth_type<I, Ts...>; };
+
+#endif
@@ -0,0 +1,130 @@
+#ifndef INK_PARALLEL_FOR_HEADER_FILE_GUARD
+#define INK_PARALLEL_FOR_HEADER_FILE_GUARD
+
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <utility>
+
+#include "MultiArrayIndexing.hpp"
+#include "ThreadPool.hpp"
+
+namespace ink::Indexing {
+	
+	// Fewest cells per block, unless the whole array is smaller; below this, handing out a block costs more than running it.
+	inline constexpr size_t parallel_for_grain = 4096;
+	
+	namespace detail {
+		
+		/**
+		 * How parallel_for cuts an array into boxes: every block is size[] cells along each dimension (but for the last
+		 * along each, which may be short), and there are count[] of them along each.
+		 */
+		template<size_t dimensions> struct
+		Blocking
+		{
+			std::array<size_t, dimensions> size{}, count{};
+			size_t total = 0;
+		};
+		
+		/**
+		 * Blocks of about target cells, shaped as whole rows where they fit: whole extents along the first dimensions, and
+		 * part of the next one. A single row longer than target is cut into segments instead. Every block is then a run of
+		 * consecutive memory (rows), or a slab of consecutive rows, rather than whatever a cut of the flat range would give.
+		 */
+		template<size_t dimensions> constexpr Blocking<dimensions>
+		MakeBlocking(std::array<size_t, dimensions> const& extents, size_t target)
+		{
+			Blocking<dimensions> out;
+			out.size.fill(1);
+			
+			for (size_t d = 0, left = std::max<size_t>(target, 1); d < dimensions; d++)
+			{
+				if (left >= extents[d]) { out.size[d] = std::max<size_t>(extents[d], 1); left /= out.size[d]; }
+				else { out.size[d] = left; break; }
+			}
+			
+			out.total = 1;
+			for (size_t d = 0; d < dimensions; d++) { out.count[d] = (extents[d] + out.size[d] - 1) / out.size[d]; out.total *= out.count[d]; }
+			return out;
+		}
+		
+		/**
+		 * Runs f over every cell of the box [first, last) of an array of the given extents: row by row, with a plain loop
+		 * along the first dimension, so f can be inlined and vectorized there.
+		 */
+		template<size_t dimensions, typename F> constexpr void
+		ForEachInBox(std::array<size_t, dimensions> const& extents, std::array<size_t, dimensions> const& first, std::array<size_t, dimensions> last, F& f)
+		{
+			const size_t x0 = first[0], x1 = last[0];
+			last[0] = x0 + 1;
+			
+			for (Cell<dimensions> row : CellRange<dimensions>(extents, first, last))
+			{
+				if constexpr (std::invocable<F&, Cell<dimensions> const&>)
+				{
+					Cell<dimensions> cell = row;
+					for (size_t x = x0; x < x1; x++, cell.absolute++) { cell.coordinates[0] = x; f(std::as_const(cell)); }
+				}
+				else
+				{
+					[&]<size_t... d>(std::index_sequence<d...>) {
+						for (size_t x = x0; x < x1; x++) f(x, row.coordinates[d + 1]...);
+					}(std::make_index_sequence<dimensions - 1>{});
+				}
+			}
+		}
+		
+	}
+	
+	/**
+	 * @brief Calls f on every cell of an array of the given extents (first dimension fastest, as for TransposeToAbsolute),
+	 * spread over the threads of pool. Either as f(x, y, z, ...), one coordinate per dimension, or as f(cell), with a
+	 * Cell holding the absolute index as well:
+	 *
+	 * 	ink::Indexing::parallel_for({ W, H, D }, [&](size_t x, size_t y, size_t z) { out[at(x, y, z)] = Blur(in, x, y, z); });
+	 *
+	 * The array is cut into blocks of whole rows, or slabs of them (see detail::MakeBlocking), around eight per thread
+	 * and at least parallel_for_grain cells each; they are then handed out by ThreadPool::Run(), work stealing included.
+	 * Cells within a block are visited in order, with no division past the block's first; the order between blocks, and
+	 * the thread each runs on, are unspecified. f is called concurrently, and must not write to anything another cell reads.
+	 */
+	template<size_t dimensions, typename F> requires (dimensions > 0) void
+	parallel_for(ThreadPool& pool, std::array<size_t, dimensions> const& extents, F&& f)
+	{
+		size_t cells = 1;
+		for (size_t e : extents) cells *= e;
+		if (cells == 0) return;
+		
+		const auto blocking = detail::MakeBlocking(extents, std::max(cells / (pool.Size() * 8), std::min(cells, parallel_for_grain)));
+		
+		pool.Run(blocking.total, [&](size_t block) {
+			std::array<size_t, dimensions> first, last;
+			for (size_t d = 0; d < dimensions; d++)
+			{
+				first[d] = block % blocking.count[d] * blocking.size[d];
+				last[d] = std::min(first[d] + blocking.size[d], extents[d]);
+				block /= blocking.count[d];
+			}
+			detail::ForEachInBox(extents, first, last, f);
+		});
+	}
+	
+	// As above, over the shared pool.
+	template<size_t dimensions, typename F> requires (dimensions > 0) void
+	parallel_for(std::array<size_t, dimensions> const& extents, F&& f)
+	{ parallel_for(ThreadPool::Shared(), extents, std::forward<F>(f)); }
+	
+	// As above, with the extents given in braces: | parallel_for({ W, H }, f) |.
+	template<size_t dimensions, typename F> requires (dimensions > 0) void
+	parallel_for(size_t const (&extents)[dimensions], F&& f)
+	{ parallel_for(ThreadPool::Shared(), std::to_array(extents), std::forward<F>(f)); }
+	
+	template<size_t dimensions, typename F> requires (dimensions > 0) void
+	parallel_for(ThreadPool& pool, size_t const (&extents)[dimensions], F&& f)
+	{ parallel_for(pool, std::to_array(extents), std::forward<F>(f)); }
+	
+}
+
+#endif
@@ -0,0 +1,190 @@
+#ifndef INK_UTILITY_PERFECT_HASH_HEADER_FILE_GUARD
+#define INK_UTILITY_PERFECT_HASH_HEADER_FILE_GUARD
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+
+namespace ink {
+	
+	namespace detail {
+		
+		// The 64-bit finalizer of MurmurHash3; every input bit affects every output bit.
+		constexpr uint64_t
+		fmix64(uint64_t h)
+		{
+			h ^= h >> 33; h *= 0xff51afd7ed558ccdull;
+			h ^= h >> 33; h *= 0xc4ceb9fe1a85ec53ull;
+			h ^= h >> 33;
+			return h;
+		}
+		
+		// Little-endian value of the bytes [at, at + count) of s.
+		constexpr uint64_t
+		bytes_le(std::string_view s, size_t at, size_t count)
+		{
+			if (!std::is_constant_evaluated() && std::endian::native == std::endian::little)
+			{
+				// Whole words in one load, and shorter runs in at most two, overlapping as needed; the result is the same.
+				uint64_t out = 0;
+				if (count == 8) std::memcpy(&out, s.data() + at, 8);
+				else if (count >= 4)
+				{
+					uint32_t low = 0, high = 0;
+					std::memcpy(&low, s.data() + at, 4);
+					std::memcpy(&high, s.data() + at + count - 4, 4);
+					out = low | uint64_t(high) << (8 * (count - 4));
+				}
+				else if (count > 0)
+				{
+					out = uint64_t(uint8_t(s[at])) | uint64_t(uint8_t(s[at + count / 2])) << (8 * (count / 2)) | uint64_t(uint8_t(s[at + count - 1])) << (8 * (count - 1));
+				}
+				return out;
+			}
+			
+			uint64_t out = 0;
+			for (size_t b = 0; b < count; b++) out |= uint64_t(uint8_t(s[at + b])) << (8 * b);
+			return out;
+		}
+		
+		// Hash of a string, 8 bytes at a time. The same in constant expressions as at runtime, where the tables it fills are used.
+		constexpr uint64_t
+		string_hash(std::string_view s)
+		{
+			uint64_t h = 0x9e3779b97f4a7c15ull ^ s.size();
+			size_t i = 0;
+			for (; i + 8 <= s.size(); i += 8)
+			{
+				h = (h ^ bytes_le(s, i, 8)) * 0x100000001b3ull;
+				h ^= h >> 29;
+			}
+			return fmix64(h ^ bytes_le(s, i, s.size() - i));
+		}
+		
+		// Maps a 32-bit value onto [0, n), without a division.
+		constexpr size_t
+		reduce(uint64_t x32, size_t n)
+		{ return size_t((x32 * n) >> 32); }
+		
+	}
+	
+	/**
+	 * @brief A minimal perfect hash over a fixed set of N distinct strings: every key maps to its own slot of exactly N,
+	 * so a lookup is a single string hash, two table loads and one string comparison, whatever N:
+	 *
+	 * 	static constexpr ink::PerfectHash<3> COLORS({ "red", "green", "blue" });
+	 * 	static_assert(COLORS.Find("green") == 1);
+	 * 	static_assert(!COLORS.Find("mauve"));
+	 *
+	 * Built by hash and displace: the keys are first spread over N/2 buckets by one half of their hash; then, largest bucket
+	 * first, each bucket looks for the smallest displacement that sends all of its keys to free slots, through the other
+	 * half remixed with it. Construction is constexpr, so the whole table can be built at compile time (a few hundred keys
+	 * take well under the default constexpr step limits), and fails to compile if two keys are equal.
+	 */
+	template<size_t N>
+	class PerfectHash {
+		
+		static_assert(N > 0 && N < (size_t(1) << 32), "PerfectHash covers 1 to 2^32 - 1 keys");
+		
+		private: static constexpr size_t
+		BUCKETS = (N + 1) / 2;
+		
+		/**
+		 * @param keys The strings to hash, which must all differ. Only viewed, never copied: they must outlive the table,
+		 * which string literals always do.
+		 */
+		public: constexpr explicit
+		PerfectHash(std::array<std::string_view, N> const& keys):
+		keys(keys)
+		{
+			std::array<uint64_t, N> hashes{};
+			std::array<uint32_t, BUCKETS + 1> starts{};
+			std::array<uint32_t, N> members{};
+			for (size_t k = 0; k < N; k++) { hashes[k] = detail::string_hash(keys[k]); starts[Bucket(hashes[k]) + 1]++; }
+			
+			// Keys grouped by bucket, counting-sort style: bucket b holds members[starts[b], starts[b + 1]).
+			for (size_t b = 0; b < BUCKETS; b++) starts[b + 1] += starts[b];
+			std::array<uint32_t, BUCKETS + 1> fill = starts;
+			for (size_t k = 0; k < N; k++) members[fill[Bucket(hashes[k])]++] = uint32_t(k);
+			
+			// Buckets from largest to smallest, so the most constrained ones pick while most slots are still free.
+			std::array<uint32_t, BUCKETS> order{};
+			for (size_t b = 0; b < BUCKETS; b++) order[b] = uint32_t(b);
+			for (size_t i = 1; i < BUCKETS; i++)
+			{
+				const uint32_t b = order[i];
+				size_t j = i;
+				for (; j > 0 && Size(starts, order[j - 1]) < Size(starts, b); j--) order[j] = order[j - 1];
+				order[j] = b;
+			}
+			
+			std::array<bool, N> taken{};
+			std::array<uint32_t, 16> placed{};	// Slots of the bucket being placed; buckets past 16 keys are not worth planning for.
+			for (uint32_t b : order)
+			{
+				const size_t size = Size(starts, b);
+				if (size == 0) break;
+				if (size > placed.size()) throw std::logic_error("PerfectHash: too many keys share a bucket; are some keys equal?");
+				
+				for (uint32_t d = 0;; d++)
+				{
+					if (d == (uint32_t(1) << 24)) throw std::logic_error("PerfectHash: no displacement fits; are some keys equal?");
+					
+					bool fits = true;
+					for (size_t m = 0; m < size && fits; m++)
+					{
+						placed[m] = uint32_t(Slot(hashes[members[starts[b] + m]], d));
+						fits = !taken[placed[m]];
+						for (size_t o = 0; o < m && fits; o++) fits = placed[o] != placed[m];
+					}
+					if (!fits) continue;
+					
+					displacements[b] = d;
+					for (size_t m = 0; m < size; m++) { taken[placed[m]] = true; slots[placed[m]] = members[starts[b] + m]; }
+					break;
+				}
+			}
+		}
+		
+		// The index of key in the keys given to the constructor; nothing if it is not one of them.
+		public: constexpr std::optional<size_t>
+		Find(std::string_view key) const
+		{
+			const uint64_t hash = detail::string_hash(key);
+			const uint32_t index = slots[Slot(hash, displacements[Bucket(hash)])];
+			if (keys[index] != key) return std::nullopt;
+			return index;
+		}
+		
+		public: static constexpr size_t
+		size()
+		{ return N; }
+		
+		// The low half of the hash picks the bucket, and the high half, remixed with the bucket's displacement, the slot.
+		private: static constexpr size_t
+		Bucket(uint64_t hash)
+		{ return detail::reduce(uint32_t(hash), BUCKETS); }
+		
+		private: static constexpr size_t
+		Slot(uint64_t hash, uint32_t displacement)
+		{ return detail::reduce((((hash >> 32) ^ (displacement * 0x9e3779b97f4a7c15ull)) * 0xff51afd7ed558ccdull) >> 32, N); }
+		
+		private: static constexpr size_t
+		Size(std::array<uint32_t, BUCKETS + 1> const& starts, size_t bucket)
+		{ return starts[bucket + 1] - starts[bucket]; }
+		
+		private: std::array<std::string_view, N> keys;
+		private: std::array<uint32_t, BUCKETS> displacements{};
+		private: std::array<uint32_t, N> slots{};
+		
+	};
+	
+}
+
+#endif
@@ -1,6 +1,8 @@
 #ifndef INK_TMP_REBIND_UTILITY_HEADER_FILE_GUARD
 #define INK_TMP_REBIND_UTILITY_HEADER_FILE_GUARD
 
+#include <array>
+#include <cstddef>
 #include <utility>
 #include <tuple>
 #include <type_traits>
@@ -19,6 +21,9 @@ namespace ink::rebind {
 		template<typename... Types> struct
 		type_list_impl;
 		
+		template<typename... Types> struct
+		flatten_impl;
+		
 		template<auto... Values> struct
 		value_list_impl;
 		
@@ -43,9 +48,36 @@ namespace ink::rebind {
 		template<typename TypeList> struct
 		pop_first_impl;
 		
+		template<typename TypeList> struct
+		pop_last_impl;
+		
+		template<typename List, typename Sequence> struct
+		select_impl;
+		
 		template<typename List> struct
 		transform_impl;
 		
+		template<typename List> struct
+		filter_impl;
+		
+		template<typename List> struct
+		sort_impl;
+		
+		template<typename List> struct
+		unique_impl;
+		
+		template<typename Type> struct
+		index_of_impl;
+		
+		template<typename List> struct
+		set_union_impl;
+		
+		template<typename List> struct
+		set_intersection_impl;
+		
+		template<typename List> struct
+		set_difference_impl;
+		
 		template<typename Type> struct
 		repeat_impl;
 		
@@ -56,11 +88,13 @@ namespace ink::rebind {
 		
 		/* Aliases */
 		
+		// Naming a list must not instantiate it; otherwise its reverse/pop_first/pop_last members would instantiate
+		// every list reachable from it, one nesting level per element.
 		template<typename... T> using
-		type_list = Invoke< type_list_impl<T...> >;
+		type_list = Invoke< flatten_impl<T...> >;
 		
 		template<auto... V> using
-		value_list = Invoke< value_list_impl<V...> >;
+		value_list = value_list_impl<V...>;
 		
 		template<typename Concrete> using
 		pack = Invoke< pack_impl<Concrete> >;
@@ -84,11 +118,32 @@ namespace ink::rebind {
 		pop_first = Invoke< pop_first_impl<TypeList> >;
 		
 		template<typename TypeList> using
-		pop_last = reverse<pop_first<reverse<TypeList>>>;
+		pop_last = Invoke< pop_last_impl<TypeList> >;
 		
 		template<typename List> using
 		transform = Invoke< transform_impl<List> >;
 		
+		template<typename List> using
+		filter = Invoke< filter_impl<List> >;
+		
+		template<typename List> using
+		sort = Invoke< sort_impl<List> >;
+		
+		template<typename List> using
+		unique = Invoke< unique_impl<List> >;
+		
+		template<typename Type> using
+		index_of = Invoke< index_of_impl<Type> >;
+		
+		template<typename List> using
+		set_union = Invoke< set_union_impl<List> >;
+		
+		template<typename List> using
+		set_intersection = Invoke< set_intersection_impl<List> >;
+		
+		template<typename List> using
+		set_difference = Invoke< set_difference_impl<List> >;
+		
 		template<typename Type> using
 		repeat = Invoke< repeat_impl<Type> >;
 		
@@ -100,67 +155,112 @@ namespace ink::rebind {
 		/* Implementations */
 		
 		/* type_list */
-			// Main usage
-			template<typename... T> struct
-			type_list_impl {
-				
-				using
-				type = type_list_impl;
+			// Members of every type list, the empty one included; List is the list itself. They are all templates, so none is
+			// computed before it is used.
+			template<typename List> struct
+			type_list_members {
 				
 				template<template<typename...> typename Template> using
-				unpack_into = typename unpack<type>::into<Template>;
+				unpack_into = typename unpack<List>::template into<Template>;
 				
 				template<typename Concrete> using
-				emplace_onto = typename emplace<type>::onto<Concrete>;
+				emplace_onto = typename emplace<List>::template onto<Concrete>;
 				
 				template<typename TypeList> using
-				concat_with = typename concat<type>::with<TypeList>;
+				concat_with = typename concat<List>::template with<TypeList>;
 				
 				template<size_t TypeIndex> using
-				get = typename what_is<TypeIndex>::in<type>;
+				get = typename what_is<TypeIndex>::template in<List>;
+				
+				template<template<typename> typename Trans> using
+				transform_with = typename transform<List>::template with<Trans>;
+				
+				template<template<typename> typename Pred> using
+				filter_with = typename filter<List>::template with<Pred>;
+				
+				template<template<typename, typename> typename Compare> using
+				sort_by = typename sort<List>::template by<Compare>;
+				
+				// There is no unique member: unlike the templates around it, it would be computed for every list that
+				// gets instantiated, at a cost quadratic in its size. Use unique<type_list<...>> instead.
+				
+				template<typename Type> static constexpr size_t
+				index_of = detail::index_of<Type>::template in<List>;
+				
+				template<typename Type> static constexpr bool
+				contains = index_of<Type> < size_of<List>::value;
+				
+				template<typename TypeList> using
+				union_with = typename set_union<List>::template with<TypeList>;
+				
+				template<typename TypeList> using
+				intersection_with = typename set_intersection<List>::template with<TypeList>;
+				
+				template<typename TypeList> using
+				difference_with = typename set_difference<List>::template with<TypeList>;
+				
+			};
+			
+			// Main usage
+			template<typename... T> struct
+			type_list_impl : type_list_members<type_list_impl<T...>> {
 				
 				using
-				reverse = reverse<type>;
+				type = type_list_impl;
 				
 				using
-				pop_first = pop_first<type>;
+				reverse = detail::reverse<type>;
 				
 				using
-				pop_last = pop_last<type>;
+				pop_first = detail::pop_first<type>;
 				
-				template<template<typename> typename Trans> using
-				transform_with = typename transform<type>::with<Trans>;
+				using
+				pop_last = detail::pop_last<type>;
 				
 				static constexpr auto
 				size = size_of<type>::value;
 				
 			};
 			
+			// Specialize for empty case; defined last, see below
+			template<> struct
+			type_list_impl<>;
+			
+		/* flatten */
+			// Main usage
+			template<typename... types> struct
+			flatten_impl
+			{ using type = type_list_impl<types...>; };
+			
 			// Specialize for flattening; type_list<type_list<...>> will evaluate to type_list<...>
 			template<typename... types> struct
-			type_list_impl<type_list_impl<types...>>
+			flatten_impl<type_list_impl<types...>>
 			{ using type = type_list<types...>; };
-		
-			// Specialize for empty case
-			template<> struct
-			type_list_impl<>
-			{ using type = type_list_impl; };
 			
 		/* value_list */
 			// Main usage
 			template<auto... V> struct
 			value_list_impl {
 				using type = value_list_impl;
-				using type_list = type_list<decltype(V)...>;
+				using type_list = detail::type_list<decltype(V)...>;
 				
 				template<template<auto...> typename Template> using
-				unpack_into = typename unpack<type>::into<Template>;
+				unpack_into = typename unpack<type>::template into<Template>;
 				
 				template<typename Concrete> using
-				emplace_onto = typename emplace<type>::onto<Concrete>;
+				emplace_onto = typename emplace<type>::template onto<Concrete>;
 				
 				template<size_t ValueIndex> using
-				get = typename what_is<ValueIndex>::in<type>;
+				get = typename what_is<ValueIndex>::template in<type>;
+				
+				using
+				reverse = detail::reverse<type>;
+				
+				using
+				pop_first = detail::pop_first<type>;
+				
+				using
+				pop_last = detail::pop_last<type>;
 				
 				static constexpr auto
 				size = size_of<type>::value;
@@ -238,6 +338,31 @@ namespace ink::rebind {
 				
 			};
 			
+			// Specialize for empty value_list; there is nothing to pop, and every other member stays. Its members are not
+			// dependent, so it follows the unpack and emplace specializations they name.
+			template<> struct
+			value_list_impl<>
+			{
+				using type = value_list_impl;
+				using type_list = detail::type_list<>;
+				
+				template<template<auto...> typename Template> using
+				unpack_into = typename unpack<type>::template into<Template>;
+				
+				template<typename Concrete> using
+				emplace_onto = typename emplace<type>::template onto<Concrete>;
+				
+				template<size_t ValueIndex> using
+				get = typename what_is<ValueIndex>::template in<type>;
+				
+				using
+				reverse = type;
+				
+				static constexpr size_t
+				size = 0;
+				
+			};
+			
 		/* concat */
 			// Types first concatenation
 			template<typename... types1> struct
@@ -281,13 +406,55 @@ namespace ink::rebind {
 				
 			};
 			
+		/* nth_type */
+			// Constant-depth pack indexing; every get/what_is goes through here instead of std::tuple_element.
+			#if defined(__has_builtin)
+				#if __has_builtin(__type_pack_element)
+					#define INK_REBIND_TYPE_PACK_ELEMENT
+				#endif
+			#endif
+			
+			#if defined(INK_REBIND_TYPE_PACK_ELEMENT)
+			
+			// Compiler intrinsic; no instantiations at all.
+			template<size_t TypeIndex, typename... types> using
+			nth_type = __type_pack_element<TypeIndex, types...>;
+			
+			#else
+			
+			// Fallback: one class inheriting from an (index, type) pair per element. The wanted pair is picked out by overload
+			// resolution against its base, so a lookup never recurses, and the indexer is shared by every lookup into the same pack.
+			template<size_t I, typename T> struct
+			indexed
+			{ using type = T; };
+			
+			template<typename Sequence, typename... types> struct
+			indexer;
+			
+			template<size_t... I, typename... types> struct
+			indexer<std::index_sequence<I...>, types...>: indexed<I, types>...
+			{};
+			
+			template<size_t I, typename T> static indexed<I, T>
+			select(indexed<I, T> const&);
+			
+			template<size_t TypeIndex, typename... types> using
+			nth_type = typename decltype(select<TypeIndex>(std::declval< indexer<std::index_sequence_for<types...>, types...> const& >()))::type;
+			
+			#endif
+			
+			// Wraps a value as a type, so that value lists are indexed exactly like type lists.
+			template<auto val> struct
+			Value
+			{ static constexpr auto value = val; };
+			
 		/* get_type */
 			template<size_t TypeIndex, typename TypeList> struct
 			get_type_impl;
 			// This is "main usage", but is more comfortable to use from within what_is, for packing and unpacking syntax
 			template<size_t TypeIndex, typename... types> struct
 			get_type_impl<TypeIndex, type_list_impl<types...>>
-			{ using type = std::tuple_element_t<TypeIndex, std::tuple<types...> >; };
+			{ using type = nth_type<TypeIndex, types...>; };
 			
 		/* what_is */
 			// Main usage
@@ -299,14 +466,11 @@ namespace ink::rebind {
 				
 				template<typename... types>
 				struct in_impl<type_list_impl<types...>>
-				{ using type = std::tuple_element_t<TypeIndex, std::tuple<types...>>; };
-				
-				template<auto val> struct Value
-				{ static constexpr auto value = val; };
+				{ using type = nth_type<TypeIndex, types...>; };
 				
 				template<auto... values>
 				struct in_impl<value_list_impl<(values)...>>
-				{ using type = Value<std::get<TypeIndex>(std::make_tuple(values...))>; };
+				{ using type = nth_type<TypeIndex, Value<values>...>; };
 				
 				public:
 				using type = what_is_impl;
@@ -315,29 +479,65 @@ namespace ink::rebind {
 				
 			};
 			
+		/* select */
+			// Picks the elements at the given indices, in order, with a single pack expansion; nothing here recurses.
+			template<typename... types, size_t... I> struct
+			select_impl<type_list_impl<types...>, std::index_sequence<I...>>
+			{ using type = type_list_impl<nth_type<I, types...>...>; };
+			
+			// Values are wrapped once, selected as a type list, and unwrapped once at the end.
+			template<auto... values, size_t... I> struct
+			select_impl<value_list_impl<values...>, std::index_sequence<I...>>
+			{
+				private:
+				template<typename TypeList> struct unwrap;
+				template<auto... selected> struct
+				unwrap<type_list_impl<Value<selected>...>>
+				{ using type = value_list_impl<selected...>; };
+				
+				public:
+				using type = Invoke< unwrap<Invoke< select_impl<type_list_impl<Value<values>...>, std::index_sequence<I...>> >> >;
+			};
+			
 		/* reverse */
 			// Main usage
-			template<typename T, typename... Ts> struct
-			reverse_impl<type_list_impl<T, Ts...>>
+			template<typename List> struct
+			reverse_impl
 			{
-				using head = type_list<T>;
-				using tail = Invoke< reverse_impl<type_list<Ts...>> >;
+				private:
+				static constexpr auto last = size_of<List>::value - 1;
+				
+				template<typename Sequence> struct reversed;
+				template<size_t... I> struct
+				reversed<std::index_sequence<I...>>
+				{ using type = std::index_sequence<(last - I)...>; };
 				
-				using type = typename concat<tail>::with<head>;
-				// using type = decltype(std::tuple_cat(std::declval<tail>(), std::declval<head>()));
+				public:
+				using type = Invoke< select_impl<List, Invoke< reversed<std::make_index_sequence<size_of<List>::value>> >> >;
 			};
 			
-			// Empty specialization
-			template<>
-			struct reverse_impl<type_list<>>
-			{ using type = type_list<>; };
-			
 		/* pop_first */
 			// Main usage
 			template<typename First, typename... types> struct
 			pop_first_impl<type_list_impl<First,types...>>
 			{ using type = type_list<types...>; };
 			
+			// Value usage
+			template<auto first, auto... values> struct
+			pop_first_impl<value_list_impl<first, values...>>
+			{ using type = value_list<values...>; };
+			
+		/* pop_last */
+			// Main usage
+			template<typename First, typename... types> struct
+			pop_last_impl<type_list_impl<First, types...>>
+			{ using type = Invoke< select_impl<type_list_impl<First, types...>, std::index_sequence_for<types...>> >; };
+			
+			// Value usage
+			template<auto first, auto... values> struct
+			pop_last_impl<value_list_impl<first, values...>>
+			{ using type = Invoke< select_impl<value_list_impl<first, values...>, std::index_sequence_for<decltype(values)...>> >; };
+			
 		/* transform */
 			// Main usage
 			template<typename... types> struct
@@ -350,26 +550,239 @@ namespace ink::rebind {
 				using type = transform_impl;
 			};
 			
-		/* repeat */
+		/* keep */
+			// Keeps the elements whose flag is set; the indices are worked out in a constexpr function, not by recursion.
+			template<typename List, bool... keep> struct
+			keep_impl
+			{
+				private:
+				static constexpr size_t count = (size_t{0} + ... + size_t{keep});
+				
+				static constexpr std::array<size_t, count>
+				kept = [] {
+					std::array<size_t, count> out{};
+					std::array<bool, sizeof...(keep)> flags{keep...};
+					for (size_t i = 0, n = 0; i < flags.size(); ++i) if (flags[i]) out[n++] = i;
+					return out;
+				}();
+				
+				template<typename Sequence> struct indices;
+				template<size_t... I> struct
+				indices<std::index_sequence<I...>>
+				{ using type = std::index_sequence<kept[I]...>; };
+				
+				public:
+				using type = Invoke< select_impl<List, Invoke< indices<std::make_index_sequence<count>> >> >;
+			};
+			
+		/* filter */
+			// Main usage
+			template<typename... types> struct
+			filter_impl<type_list_impl<types...>>
+			{
+				public:
+				template<template<typename> typename Pred> using
+				with = Invoke< keep_impl<type_list_impl<types...>, bool(Pred<types>::value)...> >;
+				
+				using type = filter_impl;
+			};
+			
+		/* index_of */
+			// Main usage; the index of the first occurrence of Type, or the size of the list if there is none.
+			template<typename Type> struct
+			index_of_impl
+			{
+				private:
+				template<typename List> struct in_impl;
+				template<typename... types> struct
+				in_impl<type_list_impl<types...>>
+				{
+					static constexpr size_t value = [] {
+						std::array<bool, sizeof...(types)> same{std::is_same_v<Type, types>...};
+						size_t i = 0;
+						while (i < same.size() && !same[i]) ++i;
+						return i;
+					}();
+				};
+				
+				public:
+				using type = index_of_impl;
+				template<typename List> static constexpr size_t
+				in = in_impl<List>::value;
+			};
+			
+		/* unique */
+			// Main usage; keeps the first occurrence of every type.
+			template<typename... types> struct
+			unique_impl<type_list_impl<types...>>
+			{
+				private:
+				template<typename Sequence> struct firsts;
+				template<size_t... I> struct
+				firsts<std::index_sequence<I...>>
+				{ using type = Invoke< keep_impl<type_list_impl<types...>, (index_of<types>::template in<type_list_impl<types...>> == I)...> >; };
+				
+				public:
+				using type = Invoke< firsts<std::index_sequence_for<types...>> >;
+			};
+			
+		/* set algebra */
+			// All three keep the order in which types first appear, and never repeat a type.
+			template<typename... types1> struct
+			set_union_impl<type_list_impl<types1...>>
+			{
+				private:
+				template<typename List> struct with_impl;
+				template<typename... types2> struct
+				with_impl<type_list_impl<types2...>>
+				{ using type = unique<type_list_impl<types1..., types2...>>; };
+				
+				public:
+				using type = set_union_impl;
+				template<typename List> using
+				with = Invoke< with_impl<List> >;
+			};
+			
+			template<typename... types1> struct
+			set_intersection_impl<type_list_impl<types1...>>
+			{
+				private:
+				template<typename List> struct with_impl;
+				template<typename... types2> struct
+				with_impl<type_list_impl<types2...>>
+				{ using type = unique< Invoke< keep_impl<type_list_impl<types1...>, (index_of<types1>::template in<type_list_impl<types2...>> < sizeof...(types2))...> > >; };
+				
+				public:
+				using type = set_intersection_impl;
+				template<typename List> using
+				with = Invoke< with_impl<List> >;
+			};
+			
+			template<typename... types1> struct
+			set_difference_impl<type_list_impl<types1...>>
+			{
+				private:
+				template<typename List> struct with_impl;
+				template<typename... types2> struct
+				with_impl<type_list_impl<types2...>>
+				{ using type = unique< Invoke< keep_impl<type_list_impl<types1...>, (index_of<types1>::template in<type_list_impl<types2...>> == sizeof...(types2))...> > >; };
+				
+				public:
+				using type = set_difference_impl;
+				template<typename List> using
+				with = Invoke< with_impl<List> >;
+			};
+			
+		/* sort */
+			// Number of elements of List that end up ahead of Type when merging, found by binary search over [Low, High).
+			// With TiesAhead, elements comparing equal to Type go ahead of it, which keeps the merge stable.
+			template<template<typename, typename> typename Compare, typename Type, bool TiesAhead, typename List, size_t Low, size_t High, bool = (Low < High)> struct
+			rank_impl
+			{
+				private:
+				static constexpr size_t mid = (Low + High) / 2;
+				using pivot = Invoke< get_type_impl<mid, List> >;
+				static constexpr bool ahead = TiesAhead ? !Compare<Type, pivot>::value : bool(Compare<pivot, Type>::value);
+				
+				public:
+				static constexpr size_t value = std::conditional_t<ahead,
+					rank_impl<Compare, Type, TiesAhead, List, mid + 1, High>,
+					rank_impl<Compare, Type, TiesAhead, List, Low, mid>
+				>::value;
+			};
+			
+			template<template<typename, typename> typename Compare, typename Type, bool TiesAhead, typename List, size_t Low, size_t High> struct
+			rank_impl<Compare, Type, TiesAhead, List, Low, High, false>
+			{ static constexpr size_t value = Low; };
+			
+			// Merges two sorted lists; every element's final position is its own index plus its rank in the other list.
+			template<template<typename, typename> typename Compare, typename Left, typename Right> struct
+			merge_impl;
 			
-			template<size_t N, typename T> struct repeat_n_times_impl
+			template<template<typename, typename> typename Compare, typename... left, typename... right> struct
+			merge_impl<Compare, type_list_impl<left...>, type_list_impl<right...>>
 			{
-				template<typename> using make = T;
-				using type = typename pack<std::make_index_sequence<N>>::type_list::transform<make>;
+				private:
+				using lefts = type_list_impl<left...>;
+				using rights = type_list_impl<right...>;
+				static constexpr size_t count = sizeof...(left) + sizeof...(right);
+				
+				template<typename LeftSequence, typename RightSequence> struct positions;
+				template<size_t... I, size_t... J> struct
+				positions<std::index_sequence<I...>, std::index_sequence<J...>>
+				{
+					static constexpr std::array<size_t, count> value {
+						(I + rank_impl<Compare, left, false, rights, 0, sizeof...(right)>::value)...,
+						(J + rank_impl<Compare, right, true, lefts, 0, sizeof...(left)>::value)...
+					};
+				};
+				
+				static constexpr std::array<size_t, count>
+				order = [] {
+					constexpr auto at = positions<std::index_sequence_for<left...>, std::index_sequence_for<right...>>::value;
+					std::array<size_t, count> out{};
+					for (size_t i = 0; i < count; ++i) out[at[i]] = i;
+					return out;
+				}();
+				
+				template<typename Sequence> struct indices;
+				template<size_t... I> struct
+				indices<std::index_sequence<I...>>
+				{ using type = std::index_sequence<order[I]...>; };
+				
+				public:
+				using type = Invoke< select_impl<type_list_impl<left..., right...>, Invoke< indices<std::make_index_sequence<count>> >> >;
+			};
+			
+			// Main usage; a stable merge sort. Splitting and merging are both flat, so only the halving nests: log2(N) deep.
+			template<typename... types> struct
+			sort_impl<type_list_impl<types...>>
+			{
+				private:
+				static constexpr size_t half = sizeof...(types) / 2;
+				
+				template<typename Sequence> struct offset;
+				template<size_t... I> struct
+				offset<std::index_sequence<I...>>
+				{ using type = std::index_sequence<(half + I)...>; };
+				
+				template<template<typename, typename> typename Compare, bool = (sizeof...(types) > 1)> struct
+				by_impl
+				{ using type = type_list_impl<types...>; };
+				
+				template<template<typename, typename> typename Compare> struct
+				by_impl<Compare, true>
+				{
+					using left = Invoke< select_impl<type_list_impl<types...>, std::make_index_sequence<half>> >;
+					using right = Invoke< select_impl<type_list_impl<types...>, Invoke< offset<std::make_index_sequence<sizeof...(types) - half>> >> >;
+					using type = Invoke< merge_impl<Compare, typename sort<left>::template by<Compare>, typename sort<right>::template by<Compare>> >;
+				};
+				
+				public:
+				using type = sort_impl;
+				template<template<typename, typename> typename Compare> using
+				by = Invoke< by_impl<Compare> >;
 			};
 			
+		/* repeat */
 			// Main usage
 			template<typename Type> struct
 			repeat_impl
 			{
-				private: template<typename> using
+				private:
+				template<size_t> using
 				make = Type;
 				
+				template<typename Sequence> struct times_impl;
+				template<size_t... I> struct
+				times_impl<std::index_sequence<I...>>
+				{ using type = type_list_impl<make<I>...>; };
+				
 				public:
 				using type = repeat_impl;
 				
 				template<size_t N> using
-				times = typename pack<std::make_index_sequence<N>>::type_list::transform<make>;
+				times = Invoke< times_impl<std::make_index_sequence<N>> >;
 				
 			};
 			
@@ -377,7 +790,7 @@ namespace ink::rebind {
 			// Generic usage
 			template<typename... Types> struct
 			size_impl
-			{ using type = size_impl; static constexpr auto value = std::tuple_size_v<std::tuple<Types...>>; };
+			{ using type = size_impl; static constexpr auto value = sizeof...(Types); };
 			
 			// Packed types usage
 			template<typename... Types> struct
@@ -389,6 +802,23 @@ namespace ink::rebind {
 			size_impl<value_list_impl<Values...>>
 			{ using type = size_of<decltype(Values)...>; };
 			
+		/* type_list<> */
+			// There is nothing to pop, and the list is its own reverse. Its members are not dependent, so it follows every
+			// specialization they name.
+			template<> struct
+			type_list_impl<> : type_list_members<type_list_impl<>> {
+				
+				using
+				type = type_list_impl;
+				
+				using
+				reverse = type;
+				
+				static constexpr size_t
+				size = 0;
+				
+			};
+			
 	}
 	
 	// Exposed API
@@ -404,12 +834,20 @@ namespace ink::rebind {
 	using detail::concat;
 	using detail::reverse;
 	using detail::transform;
+	using detail::filter;
+	using detail::sort;
+	using detail::unique;
+	
+	using detail::set_union;
+	using detail::set_intersection;
+	using detail::set_difference;
 	
 	using detail::pop_first;
 	using detail::pop_last;
 	
 	using detail::what_is;
 	using detail::size_of;
+	using detail::index_of;
 	
 }
 
@@ -0,0 +1,203 @@
+#ifndef INK_UTILITY_SIGNAL_BANK_HEADER_FILE_GUARD
+#define INK_UTILITY_SIGNAL_BANK_HEADER_FILE_GUARD
+
+#include <array>
+#include <bit>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <span>
+
+namespace ink {
+	
+	/**
+	 * A fixed set of N bits, packed into 64-bit words. Returned by the SignalBank queries.
+	 * Besides the usual per-bit access, it can be iterated, which visits the index of every set bit in ascending order:
+	 *
+	 * 	for (size_t channel : bank.fall()) printf("CHANNEL %zu PRESSED.\n", channel);
+	 */
+	template<size_t N>
+	class SignalMask {
+		
+		public: static constexpr size_t WORDS = (N + 63) / 64;
+		
+		// Visits the index of each set bit, skipping whole zero words at a time.
+		// Dereferencing yields the index by value, so to the legacy iterator requirements it is only an input iterator.
+		public: class iterator {
+			
+			public: using iterator_concept = std::forward_iterator_tag;
+			public: using iterator_category = std::input_iterator_tag;
+			public: using value_type = size_t;
+			public: using difference_type = std::ptrdiff_t;
+			public: using pointer = void;
+			public: using reference = size_t;
+			
+			public: constexpr
+			iterator() = default;
+			
+			public: constexpr
+			iterator(uint64_t const* words, size_t word):
+			words(words), word(word), rest(word < WORDS ? words[word] : 0)
+			{ skip(); }
+			
+			public: constexpr size_t
+			operator*() const
+			{ return word * 64 + std::countr_zero(rest); }
+			
+			public: constexpr iterator&
+			operator++()
+			{ rest &= rest - 1; skip(); return *this; }
+			
+			public: constexpr iterator
+			operator++(int)
+			{ iterator out = *this; ++*this; return out; }
+			
+			public: constexpr bool
+			operator==(iterator const& other) const
+			{ return word == other.word && rest == other.rest; }
+			
+			private: constexpr void
+			skip()
+			{ while (rest == 0 && ++word < WORDS) rest = words[word]; }
+			
+			private: uint64_t const* words = nullptr;
+			private: size_t word = WORDS;
+			private: uint64_t rest = 0;
+			
+		};
+		
+		public: std::array<uint64_t, WORDS> words{};
+		
+		public: constexpr bool
+		test(size_t i) const
+		{ return (words[i / 64] >> (i % 64)) & 1; }
+		
+		public: constexpr bool
+		operator[](size_t i) const
+		{ return test(i); }
+		
+		// Number of set bits.
+		public: constexpr size_t
+		count() const
+		{ size_t out = 0; for (auto w : words) out += std::popcount(w); return out; }
+		
+		public: constexpr bool
+		any() const
+		{ uint64_t out = 0; for (auto w : words) out |= w; return out != 0; }
+		
+		public: constexpr bool
+		none() const
+		{ return !any(); }
+		
+		public: constexpr iterator
+		begin() const
+		{ return iterator(words.data(), 0); }
+		
+		public: constexpr iterator
+		end() const
+		{ return iterator(); }
+		
+		public: std::bitset<N>
+		to_bitset() const
+		{
+			std::bitset<N> out;
+			for (size_t w = WORDS; w-- > 0;) { out <<= 64; out |= std::bitset<N>(words[w]); }
+			return out;
+		}
+		
+		public: friend constexpr SignalMask
+		operator&(SignalMask const& lhs, SignalMask const& rhs)
+		{ SignalMask out; for (size_t w = 0; w < WORDS; w++) out.words[w] = lhs.words[w] & rhs.words[w]; return out; }
+		
+		public: friend constexpr SignalMask
+		operator|(SignalMask const& lhs, SignalMask const& rhs)
+		{ SignalMask out; for (size_t w = 0; w < WORDS; w++) out.words[w] = lhs.words[w] | rhs.words[w]; return out; }
+		
+		public: friend constexpr bool
+		operator==(SignalMask const& lhs, SignalMask const& rhs) = default;
+		
+	};
+	
+	/**
+	 * Bit-packed bank of N SignalData-like channels. The previous and current states of every channel are kept as 64-bit
+	 * words, so a whole tick is a single Update(), and each query is one bitwise operation per word:
+	 *
+	 * 	...
+	 * 	SignalBank<4096> Inputs;
+	 *	while (Running) {
+	 * 		uint64_t states[SignalBank<4096>::WORDS] = ( ´Retrieve packed channel states´ );
+	 *
+	 * 		Inputs.Update(states);
+	 *
+	 * 		for (size_t channel : Inputs.fall()) printf("CHANNEL %zu PRESSED.\n", channel);
+	 * 		if ( Inputs.held(42) ) puts("CHANNEL 42 HELD.");
+	 *	}
+	 *	...
+	 *
+	 * Channel i lives in bit (i % 64) of word (i / 64). Bits past N in the last word are ignored.
+	 */
+	template<size_t N>
+	class SignalBank {
+		
+		public: using Mask = SignalMask<N>;
+		public: static constexpr size_t WORDS = Mask::WORDS;
+		
+		public: SignalBank()
+		{}
+		
+		// Provide the packed state of every channel during this tick. signals must hold at least WORDS words.
+		public: constexpr void
+		Update(std::span<uint64_t const> signals) &
+		{
+			_prev = _curr;
+			for (size_t w = 0; w < WORDS; w++) _curr.words[w] = signals[w];
+			if constexpr (N % 64 != 0) _curr.words[WORDS - 1] &= (uint64_t(1) << (N % 64)) - 1;
+		}
+		
+		// Channels active during this tick.
+		public: constexpr Mask
+		down() const
+		{ return _curr; }
+		
+		// Channels activated during this tick.
+		public: constexpr Mask
+		fall() const
+		{ Mask out; for (size_t w = 0; w < WORDS; w++) out.words[w] = ~_prev.words[w] & _curr.words[w]; return out; }
+		
+		// Channels deactivated during this tick.
+		public: constexpr Mask
+		rise() const
+		{ Mask out; for (size_t w = 0; w < WORDS; w++) out.words[w] = _prev.words[w] & ~_curr.words[w]; return out; }
+		
+		// Channels active for more than one tick (previous and current).
+		public: constexpr Mask
+		held() const
+		{ Mask out; for (size_t w = 0; w < WORDS; w++) out.words[w] = _prev.words[w] & _curr.words[w]; return out; }
+		
+		// Per-channel counterparts of the above, matching SignalData.
+		public: constexpr bool
+		down(size_t i) const
+		{ return _curr.test(i); }
+		
+		public: constexpr bool
+		fall(size_t i) const
+		{ return !_prev.test(i) && down(i); }
+		
+		public: constexpr bool
+		rise(size_t i) const
+		{ return _prev.test(i) && !down(i); }
+		
+		public: constexpr bool
+		held(size_t i) const
+		{ return _prev.test(i) && down(i); }
+		
+		private: Mask
+		_prev{},
+		_curr{};
+		
+	};
+	
+}
+
+#endif
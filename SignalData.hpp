@@ -1,6 +1,9 @@
 #ifndef INK_UTILITY_SIGNAL_DATA_ABSTRACTION_HEADER_FILE_GUARD
 #define INK_UTILITY_SIGNAL_DATA_ABSTRACTION_HEADER_FILE_GUARD
 
+#include <atomic>
+#include <cstdint>
+
 namespace ink {
 	
 	/**
@@ -62,6 +65,103 @@ namespace ink {
 		
 	};
 	
+	/**
+	 * Variant of SignalData for when the signal is sampled on a different thread than the one consuming it.
+	 * The sampler thread calls Publish() as often as it likes; the logic thread calls Update() once per tick to latch a view.
+	 * Both sides are wait-free: the whole shared state is a single atomic word, holding the current signal and a count of
+	 * every transition so far, with exactly one writer.
+	 * 
+	 * 	...
+	 * 	ConcurrentSignalData Up_Button;
+	 * 	
+	 * 	// Sampler thread
+	 * 	while (Running) Up_Button.Publish( ´Retrieve State of Up Button on Keyboard´ );
+	 * 	
+	 * 	// Logic thread
+	 *	while (Running) {
+	 * 		Up_Button.Update();
+	 * 		
+	 * 		if ( Up_Button.fall() )	puts("UP BUTTON PRESSED.");
+	 * 		if ( Up_Button.rise() )	puts("UP BUTTON RELEASED.");
+	 *	}
+	 *	...
+	 * 
+	 * Because transitions are counted rather than sampled, a press that starts and ends between two ticks is not lost:
+	 * that tick reports down(), fall() and rise() all at once.
+	*/
+	class ConcurrentSignalData {
+		
+		public: ConcurrentSignalData()
+		{}
+		
+		// Sampler thread. Provide the signal's state as of now.
+		public: void
+		Publish(bool signal) &
+		{
+			const uint64_t word = _shared.load(std::memory_order_relaxed);
+			if (bool(word & 1) != signal) _shared.store(word + 1, std::memory_order_release);
+		}
+		
+		// Logic thread. Latch everything published since the previous Update().
+		public: void
+		Update() &
+		{
+			const uint64_t word = _shared.load(std::memory_order_acquire);
+			const uint64_t transitions = word - _latched;
+			
+			_prev = _curr;
+			_curr = word & 1;
+			_presses = _prev ? transitions / 2 : (transitions + 1) / 2;
+			_releases = transitions - _presses;
+			_latched = word;
+		}
+		
+		// True if active at any point during this tick.
+		public: bool
+		down() const
+		{ return _curr || _presses > 0; }
+		
+		// True if activated during this tick.
+		public: bool
+		fall() const
+		{ return _presses > 0; }
+		
+		// True if deactivated during this tick.
+		public: bool
+		rise() const
+		{ return _releases > 0; }
+		
+		// True if active throughout both the previous and this tick, without interruption.
+		public: bool
+		held() const
+		{ return _prev && _curr && _presses == 0; }
+		
+		// Number of times the signal was activated during this tick.
+		public: uint64_t
+		presses() const
+		{ return _presses; }
+		
+		// Number of times the signal was deactivated during this tick.
+		public: uint64_t
+		releases() const
+		{ return _releases; }
+		
+		// Bit 0 is the current signal; the remaining bits count transitions. Only ever written by the sampler thread.
+		private: alignas(64) std::atomic<uint64_t>
+		_shared{0};
+		
+		// Logic thread state. Kept off the sampler's cache line.
+		private: alignas(64) uint64_t
+		_latched = 0,
+		_presses = 0,
+		_releases = 0;
+		
+		private: bool
+		_prev = false,
+		_curr = false;
+		
+	};
+	
 }
 
 #endif
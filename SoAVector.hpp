@@ -0,0 +1,509 @@
+#ifndef INK_UTILITY_SOA_VECTOR_HEADER_FILE_GUARD
+#define INK_UTILITY_SOA_VECTOR_HEADER_FILE_GUARD
+
+#include <algorithm>
+#include <compare>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "AlignedAllocator.hpp"
+#include "Rebind.hpp"
+
+namespace ink {
+	
+	namespace detail {
+		
+		/**
+		 * One soa_vector column: a growable, cache-line aligned array of T. It is std::vector minus everything soa_vector
+		 * does not use, and, unlike AlignedVector, it holds bool as a plain array rather than as packed bits.
+		 */
+		template<typename T>
+		class AlignedColumn {
+			
+			private: using Allocator = AlignedAllocator<T>;
+			
+			private: T*
+			_data = nullptr;
+			
+			private: size_t
+			_size = 0, _capacity = 0;
+			
+			public:
+			AlignedColumn() = default;
+			
+			public: explicit
+			AlignedColumn(size_t n)
+			{ resize(n); }
+			
+			public:
+			AlignedColumn(AlignedColumn const& other)
+			{
+				reserve(other._size);
+				try
+				{ std::uninitialized_copy_n(other._data, other._size, _data); }
+				catch (...)
+				{
+					// The destructor does not run for an object whose constructor throws.
+					if (_data) Allocator().deallocate(_data, _capacity);
+					throw;
+				}
+				_size = other._size;
+			}
+			
+			public:
+			AlignedColumn(AlignedColumn&& other) noexcept:
+			_data(std::exchange(other._data, nullptr)), _size(std::exchange(other._size, 0)), _capacity(std::exchange(other._capacity, 0)) {}
+			
+			public: AlignedColumn&
+			operator=(AlignedColumn other) noexcept
+			{
+				std::swap(_data, other._data);
+				std::swap(_size, other._size);
+				std::swap(_capacity, other._capacity);
+				return *this;
+			}
+			
+			public:
+			~AlignedColumn()
+			{
+				clear();
+				if (_data) Allocator().deallocate(_data, _capacity);
+			}
+			
+			public: T*
+			data()
+			{ return _data; }
+			
+			public: T const*
+			data() const
+			{ return _data; }
+			
+			public: size_t
+			size() const
+			{ return _size; }
+			
+			public: size_t
+			capacity() const
+			{ return _capacity; }
+			
+			public: T&
+			operator[](size_t i)
+			{ return _data[i]; }
+			
+			public: T&
+			back()
+			{ return _data[_size - 1]; }
+			
+			public: void
+			reserve(size_t n)
+			{
+				if (n <= _capacity) return;
+				T* grown = Allocator().allocate(n);
+				try
+				{ std::uninitialized_move_n(_data, _size, grown); }
+				catch (...)
+				{
+					Allocator().deallocate(grown, n);
+					throw;
+				}
+				std::destroy_n(_data, _size);
+				if (_data) Allocator().deallocate(_data, _capacity);
+				_data = grown;
+				_capacity = n;
+			}
+			
+			// Value-initializes new elements, or copies fill into them.
+			public: template<typename... Fill> void
+			resize(size_t n, Fill const&... fill)
+			{
+				if (n < _size) { std::destroy(_data + n, _data + _size); _size = n; return; }
+				reserve(n);
+				for (; _size < n; _size++) ::new (static_cast<void*>(_data + _size)) T(fill...);
+			}
+			
+			// When full, the new element is made in the grown buffer before the old one is let go, as args may refer into it.
+			public: template<typename... Args> T&
+			emplace_back(Args&&... args)
+			{
+				if (_size < _capacity)
+				{
+					T* slot = ::new (static_cast<void*>(_data + _size)) T(std::forward<Args>(args)...);
+					_size++;
+					return *slot;
+				}
+				
+				const size_t capacity = _capacity ? 2 * _capacity : 8;
+				T* grown = Allocator().allocate(capacity);
+				T* slot = nullptr;
+				try
+				{
+					slot = ::new (static_cast<void*>(grown + _size)) T(std::forward<Args>(args)...);
+					std::uninitialized_move_n(_data, _size, grown);
+				}
+				catch (...)
+				{
+					if (slot) std::destroy_at(slot);
+					Allocator().deallocate(grown, capacity);
+					throw;
+				}
+				
+				std::destroy_n(_data, _size);
+				if (_data) Allocator().deallocate(_data, _capacity);
+				_data = grown;
+				_capacity = capacity;
+				_size++;
+				return *slot;
+			}
+			
+			public: void
+			pop_back()
+			{ std::destroy_at(_data + --_size); }
+			
+			public: void
+			clear()
+			{ std::destroy_n(_data, _size); _size = 0; }
+			
+		};
+		
+		/**
+		 * A const soa_vector row: a std::tuple<Ts const&...>, which can also be made from a std::tuple<Ts...>. Plain, those two
+		 * tuples have no common reference, so const_iterator would not be a C++20 iterator; the specializations of
+		 * std::basic_common_reference at the end of this file make this proxy their common reference.
+		 */
+		template<typename... Ts>
+		class ConstRow : public std::tuple<Ts const&...> {
+			
+			public: using std::tuple<Ts const&...>::tuple;
+			
+			public: constexpr
+			ConstRow(std::tuple<Ts...> const& row):
+			std::tuple<Ts const&...>(row) {}
+			
+		};
+		
+	}
+	
+	template<typename List>
+	class soa_vector;
+	
+	/**
+	 * Structure-of-arrays vector, with one column per type of a Rebind type list. Every column is a separate, cache-line
+	 * aligned array, so a loop that only touches a few of the columns only pulls those through the cache:
+	 *
+	 * 	using Entities = ink::soa_vector<ink::rebind::type_list<uint32_t, bool, float, float, double, ...>>;
+	 * 	Entities entities;
+	 * 	entities.emplace_back(id, true, x, y, mass, ...);
+	 * 	for (auto [id, alive, x, y, mass, ...] : entities) ...;		// Whole rows, as tuples of references.
+	 * 	std::span<float> xs = entities.column<2>();					// One column, for SIMD loops.
+	 *
+	 * Rows go in and out as std::tuple<Ts...>. Indexing and iteration yield proxy references, std::tuple<Ts&...>,
+	 * which read and write straight through to the columns; through a const vector, they are detail::ConstRow<Ts...>, a
+	 * std::tuple<Ts const&...>. As with std::vector, anything that reallocates invalidates
+	 * iterators, references and spans.
+	 */
+	template<typename... Ts>
+	class soa_vector<rebind::detail::type_list_impl<Ts...>> {
+		
+		static_assert(sizeof...(Ts) > 0, "soa_vector needs at least one column");
+		
+		public: using value_type = std::tuple<Ts...>;
+		public: using reference = std::tuple<Ts&...>;
+		public: using const_reference = detail::ConstRow<Ts...>;
+		public: using size_type = size_t;
+		public: using difference_type = std::ptrdiff_t;
+		
+		public: template<size_t I> using column_type = rebind::detail::nth_type<I, Ts...>;
+		
+		private: using Indices = std::index_sequence_for<Ts...>;
+		
+		// Random access over rows; it holds a pointer into every column, and builds a tuple of references on dereference.
+		private: template<bool Const>
+		class row_iterator {
+			
+			friend class soa_vector;
+			template<bool> friend class row_iterator;
+			
+			public: using iterator_category = std::input_iterator_tag;
+			public: using iterator_concept = std::random_access_iterator_tag;
+			public: using value_type = soa_vector::value_type;
+			public: using difference_type = std::ptrdiff_t;
+			public: using reference = std::conditional_t<Const, soa_vector::const_reference, soa_vector::reference>;
+			public: using pointer = void;
+			
+			private: std::conditional_t<Const, std::tuple<Ts const*...>, std::tuple<Ts*...>>
+			columns{};
+			
+			private: difference_type
+			index = 0;
+			
+			private: constexpr
+			row_iterator(decltype(columns) columns, difference_type index):
+			columns(columns), index(index) {}
+			
+			public: constexpr
+			row_iterator() = default;
+			
+			// Mutable to const conversion.
+			public: template<bool Other> requires (Const && !Other) constexpr
+			row_iterator(row_iterator<Other> const& other):
+			columns(other.columns), index(other.index) {}
+			
+			public: constexpr reference
+			operator*() const
+			{ return std::apply([this](auto*... column) { return reference(column[index]...); }, columns); }
+			
+			public: constexpr reference
+			operator[](difference_type n) const
+			{ return *(*this + n); }
+			
+			public: constexpr row_iterator&
+			operator++()
+			{ ++index; return *this; }
+			
+			public: constexpr row_iterator
+			operator++(int)
+			{ auto copy = *this; ++index; return copy; }
+			
+			public: constexpr row_iterator&
+			operator--()
+			{ --index; return *this; }
+			
+			public: constexpr row_iterator
+			operator--(int)
+			{ auto copy = *this; --index; return copy; }
+			
+			public: constexpr row_iterator&
+			operator+=(difference_type n)
+			{ index += n; return *this; }
+			
+			public: constexpr row_iterator&
+			operator-=(difference_type n)
+			{ index -= n; return *this; }
+			
+			public: friend constexpr row_iterator
+			operator+(row_iterator it, difference_type n)
+			{ return it += n; }
+			
+			public: friend constexpr row_iterator
+			operator+(difference_type n, row_iterator it)
+			{ return it += n; }
+			
+			public: friend constexpr row_iterator
+			operator-(row_iterator it, difference_type n)
+			{ return it -= n; }
+			
+			public: friend constexpr difference_type
+			operator-(row_iterator const& lhs, row_iterator const& rhs)
+			{ return lhs.index - rhs.index; }
+			
+			// Only iterators into the same vector are comparable, so the index alone decides.
+			public: friend constexpr bool
+			operator==(row_iterator const& lhs, row_iterator const& rhs)
+			{ return lhs.index == rhs.index; }
+			
+			public: friend constexpr auto
+			operator<=>(row_iterator const& lhs, row_iterator const& rhs)
+			{ return lhs.index <=> rhs.index; }
+			
+		};
+		
+		public: using iterator = row_iterator<false>;
+		public: using const_iterator = row_iterator<true>;
+		
+		private: std::tuple<detail::AlignedColumn<Ts>...>
+		columns;
+		
+		// Default constructor. Empty vector.
+		public:
+		soa_vector() = default;
+		
+		// Vector of n value-initialized rows.
+		public: explicit
+		soa_vector(size_t n):
+		columns(detail::AlignedColumn<Ts>(n)...) {}
+		
+		// Vector of n copies of row.
+		public:
+		soa_vector(size_t n, value_type const& row):
+		soa_vector()
+		{ resize(n, row); }
+		
+		public: size_t
+		size() const
+		{ return std::get<0>(columns).size(); }
+		
+		public: bool
+		empty() const
+		{ return size() == 0; }
+		
+		// Smallest capacity of any column; that many rows fit without reallocating.
+		public: size_t
+		capacity() const
+		{ return std::apply([](auto const&... column) { return std::min({ column.capacity()... }); }, columns); }
+		
+		public: void
+		reserve(size_t n)
+		{ std::apply([n](auto&... column) { (column.reserve(n), ...); }, columns); }
+		
+		public: void
+		resize(size_t n)
+		{ std::apply([n](auto&... column) { (column.resize(n), ...); }, columns); }
+		
+		public: void
+		resize(size_t n, value_type const& row)
+		{ for_each_column([&]<size_t I>(auto& column) { column.resize(n, std::get<I>(row)); }); }
+		
+		public: void
+		clear()
+		{ std::apply([](auto&... column) { (column.clear(), ...); }, columns); }
+		
+		public: void
+		push_back(value_type const& row)
+		{ append([&]<size_t I>() -> decltype(auto) { return std::get<I>(row); }); }
+		
+		public: void
+		push_back(value_type&& row)
+		{ append([&]<size_t I>() -> decltype(auto) { return std::get<I>(std::move(row)); }); }
+		
+		// Constructs a row in place, from one argument per column.
+		public: template<typename... Args> requires (sizeof...(Args) == sizeof...(Ts)) reference
+		emplace_back(Args&&... args)
+		{
+			auto forwarded = std::forward_as_tuple(std::forward<Args>(args)...);
+			append([&]<size_t I>() -> decltype(auto) { return std::get<I>(std::move(forwarded)); });
+			return back();
+		}
+		
+		public: void
+		pop_back()
+		{ std::apply([](auto&... column) { (column.pop_back(), ...); }, columns); }
+		
+		// Overwrites row i with the last row, and drops the last; constant time, but does not keep the order.
+		public: void
+		swap_remove(size_t i)
+		{
+			if (i + 1 < size()) std::apply([i](auto&... column) { ((column[i] = std::move(column.back())), ...); }, columns);
+			pop_back();
+		}
+		
+		public: reference
+		operator[](size_t i)
+		{ return begin()[difference_type(i)]; }
+		
+		public: const_reference
+		operator[](size_t i) const
+		{ return begin()[difference_type(i)]; }
+		
+		public: reference
+		front()
+		{ return (*this)[0]; }
+		
+		public: const_reference
+		front() const
+		{ return (*this)[0]; }
+		
+		public: reference
+		back()
+		{ return (*this)[size() - 1]; }
+		
+		public: const_reference
+		back() const
+		{ return (*this)[size() - 1]; }
+		
+		public: iterator
+		begin()
+		{ return iterator(std::apply([](auto&... column) { return std::tuple<Ts*...>(column.data()...); }, columns), 0); }
+		
+		public: const_iterator
+		begin() const
+		{ return const_iterator(std::apply([](auto const&... column) { return std::tuple<Ts const*...>(column.data()...); }, columns), 0); }
+		
+		public: iterator
+		end()
+		{ return begin() + difference_type(size()); }
+		
+		public: const_iterator
+		end() const
+		{ return begin() + difference_type(size()); }
+		
+		public: const_iterator
+		cbegin() const
+		{ return begin(); }
+		
+		public: const_iterator
+		cend() const
+		{ return end(); }
+		
+		// The I-th column; contiguous, and aligned to a cache line.
+		public: template<size_t I> std::span<column_type<I>>
+		column()
+		{ return { std::get<I>(columns).data(), size() }; }
+		
+		public: template<size_t I> std::span<column_type<I> const>
+		column() const
+		{ return { std::get<I>(columns).data(), size() }; }
+		
+		// The first column holding T.
+		public: template<typename T> requires (rebind::type_list<Ts...>::template contains<T>) std::span<T>
+		column()
+		{ return column<rebind::type_list<Ts...>::template index_of<T>>(); }
+		
+		public: template<typename T> requires (rebind::type_list<Ts...>::template contains<T>) std::span<T const>
+		column() const
+		{ return column<rebind::type_list<Ts...>::template index_of<T>>(); }
+		
+		// Copy of row i.
+		public: value_type
+		row(size_t i) const
+		{ return value_type((*this)[i]); }
+		
+		// Calls f.template operator()<I>(column) for every column, in order.
+		private: template<typename F> void
+		for_each_column(F&& f)
+		{ [&]<size_t... I>(std::index_sequence<I...>) { (f.template operator()<I>(std::get<I>(columns)), ...); }(Indices{}); }
+		
+		/**
+		 * Appends argument<I>() to every column I, in order. If one throws, the columns before it drop what they appended,
+		 * so that every column keeps the same size.
+		 */
+		private: template<typename Argument> void
+		append(Argument&& argument)
+		{
+			size_t appended = 0;
+			try
+			{
+				for_each_column([&]<size_t I>(auto& column) { column.emplace_back(argument.template operator()<I>()); appended++; });
+			}
+			catch (...)
+			{
+				for_each_column([&]<size_t I>(auto& column) { if (I < appended) column.pop_back(); });
+				throw;
+			}
+		}
+
+	};
+	
+}
+
+// Const rows and the tuples they are read into meet at the const row, as C++20 iterators need; see ink::detail::ConstRow.
+template<typename... Ts, template<typename> typename RowQualifiers, template<typename> typename TupleQualifiers>
+struct std::basic_common_reference<ink::detail::ConstRow<Ts...>, std::tuple<Ts...>, RowQualifiers, TupleQualifiers>
+{ using type = ink::detail::ConstRow<Ts...>; };
+
+template<typename... Ts, template<typename> typename TupleQualifiers, template<typename> typename RowQualifiers>
+struct std::basic_common_reference<std::tuple<Ts...>, ink::detail::ConstRow<Ts...>, TupleQualifiers, RowQualifiers>
+{ using type = ink::detail::ConstRow<Ts...>; };
+
+// Const rows destructure like the tuples they derive from.
+template<typename... Ts>
+struct std::tuple_size<ink::detail::ConstRow<Ts...>> : std::tuple_size<std::tuple<Ts const&...>> {};
+
+template<size_t I, typename... Ts>
+struct std::tuple_element<I, ink::detail::ConstRow<Ts...>> : std::tuple_element<I, std::tuple<Ts const&...>> {};
+
+#endif
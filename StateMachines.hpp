@@ -0,0 +1,199 @@
+#ifndef INK_UTILITY_STATE_MACHINES_HEADER_FILE_GUARD
+#define INK_UTILITY_STATE_MACHINES_HEADER_FILE_GUARD
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace ink {
+	
+	/**
+	 * Many instances of the same state machine (e.g. one per entity, from a State made with MAKE_STATE.hpp), kept
+	 * bucketed by their current state rather than each holding its own. The basic, raw intended usage is as displayed:
+	 *
+	 * 	...
+	 * 	#define MAKE_STATE(v) v(Idle) v(Walk) v(Attack)
+	 * 	#include "MAKE_STATE.hpp"
+	 *
+	 * 	ink::StateMachines<State, StateCount> actors;
+	 * 	for (uint32_t id = 0; id < 100'000; id++) actors.Add(id, State::Idle);
+	 * 	actors.Apply();
+	 *
+	 * 	while (Running) {
+	 * 		actors.Run({ &IdleAll, &WalkAll, &AttackAll });	// void IdleAll(std::span<const uint32_t> ids), ...
+	 * 		actors.Apply();
+	 * 	}
+	 * 	...
+	 *
+	 * Run() calls each state's handler once, over the whole dense bucket of ids in that state, rather than dispatching
+	 * on the state of every id in turn: one (predicted) call per state per tick, and a loop the handler can vectorize.
+	 * Changes (Add(), Transition(), Remove()) are only queued, so handlers may make them freely while their span is being
+	 * walked; Apply() then carries them all out at once, in the order they were made, between ticks.
+	 *
+	 * Ids are indexes into a table of locations, grown to the largest id seen; they should be dense, as entity indexes are.
+	 * A bucket is reordered when an id leaves it (the last id takes its place), so handlers must not rely on order.
+	 */
+	template<typename State, size_t StateCount, std::unsigned_integral Entity = uint32_t> requires std::is_enum_v<State>
+	class StateMachines {
+		
+		public: using SC = std::chrono::steady_clock;
+		
+		// Per-state counters, to find out which state is blowing the tick's budget.
+		public: struct StateStatistics {
+			uint64_t runs = 0;								// Ticks this state's handler ran in (skipped while the bucket is empty).
+			uint64_t handled = 0;							// Ids handled, summed over every run.
+			uint64_t entered = 0;							// Ids moved or added into this state by Apply().
+			uint64_t left = 0;								// Ids moved or removed out of this state by Apply().
+			std::chrono::nanoseconds last_time{};			// Time the latest run took.
+			std::chrono::nanoseconds max_time{};			// Longest a single run took.
+			std::chrono::nanoseconds total_time{};			// Time of every run, summed; divide by handled for the cost per id.
+		};
+		
+		public: using Handler = void(*)(std::span<const Entity>);
+		
+		// Queues id to be added in state, or moved to state if already there.
+		public: void
+		Add(Entity id, State state)
+		{ pending.push_back(Change{ id, Index(state), true }); }
+		
+		// Queues id to be moved to state; dropped at Apply() if id is not there by then.
+		public: void
+		Transition(Entity id, State state)
+		{ pending.push_back(Change{ id, Index(state), false }); }
+		
+		// Queues id to be removed.
+		public: void
+		Remove(Entity id)
+		{ pending.push_back(Change{ id, uint32_t(StateCount), false }); }
+		
+		// Carries out every queued change, in order; later changes to the same id win. Returns the number of changes queued.
+		public: size_t
+		Apply()
+		{
+			for (Change const& change : pending)
+			{
+				if (change.id >= where.size())
+				{
+					if (!change.add) continue;
+					where.resize(size_t(change.id) + 1);
+				}
+				
+				Location& location = where[change.id];
+				if (location.state == change.state || (location.state == StateCount && !change.add)) continue;
+				
+				if (location.state != StateCount)
+				{
+					// Swap-remove from the old bucket, patching the location of whichever id took its place.
+					auto& from = buckets[location.state];
+					where[from.back()].index = location.index;
+					from[location.index] = from.back();
+					from.pop_back();
+					stats[location.state].left++;
+				}
+				
+				location.state = change.state;
+				if (change.state != StateCount)
+				{
+					auto& to = buckets[change.state];
+					location.index = uint32_t(to.size());
+					to.push_back(change.id);
+					stats[change.state].entered++;
+				}
+			}
+			
+			const size_t applied = pending.size();
+			pending.clear();
+			return applied;
+		}
+		
+		/**
+		 * Calls handler(state, ids) once for every state with any ids in it, in enum order, timing each call.
+		 * Handlers may queue changes, but nothing moves until Apply().
+		 */
+		public: template<typename F> requires std::invocable<F&, State, std::span<const Entity>> void
+		Run(F&& handler)
+		{
+			for (size_t s = 0; s < StateCount; s++)
+			{
+				if (buckets[s].empty()) continue;
+				
+				const SC::time_point start = SC::now();
+				handler(State(s), std::span<const Entity>(buckets[s]));
+				const std::chrono::nanoseconds time = SC::now() - start;
+				
+				StateStatistics& stat = stats[s];
+				stat.runs++;
+				stat.handled += buckets[s].size();
+				stat.last_time = time;
+				stat.max_time = std::max(stat.max_time, time);
+				stat.total_time += time;
+			}
+		}
+		
+		// As above, with one handler per state, in enum order.
+		public: void
+		Run(std::array<Handler, StateCount> const& handlers)
+		{ Run([&](State state, std::span<const Entity> ids) { handlers[Index(state)](ids); }); }
+		
+		// The ids currently in state, as of the latest Apply().
+		public: std::span<const Entity>
+		Entities(State state) const
+		{ return buckets[Index(state)]; }
+		
+		// The state of id, as of the latest Apply(); nothing if id is not there.
+		public: std::optional<State>
+		StateOf(Entity id) const
+		{
+			if (id >= where.size() || where[id].state == StateCount) return std::nullopt;
+			return State(where[id].state);
+		}
+		
+		// Number of ids, over every state, as of the latest Apply().
+		public: size_t
+		Size() const
+		{
+			size_t size = 0;
+			for (auto const& bucket : buckets) size += bucket.size();
+			return size;
+		}
+		
+		public: StateStatistics const&
+		Statistics(State state) const
+		{ return stats[Index(state)]; }
+		
+		public: void
+		ResetStatistics()
+		{ stats = {}; }
+		
+		private: struct Change {
+			Entity id;
+			uint32_t state;		// StateCount to remove.
+			bool add;			// Whether an id not there yet is added, rather than the change dropped.
+		};
+		
+		private: struct Location {
+			uint32_t state = uint32_t(StateCount);	// StateCount while not there.
+			uint32_t index = 0;						// Position within its bucket.
+		};
+		
+		private: static constexpr uint32_t
+		Index(State state)
+		{ return uint32_t(static_cast<std::underlying_type_t<State>>(state)); }
+		
+		private: std::array<std::vector<Entity>, StateCount> buckets;
+		private: std::array<StateStatistics, StateCount> stats{};
+		private: std::vector<Location> where;
+		private: std::vector<Change> pending;
+		
+	};
+	
+}
+
+#endif
@@ -0,0 +1,365 @@
+#ifndef INK_UTILITY_STATE_TASK_HEADER_FILE_GUARD
+#define INK_UTILITY_STATE_TASK_HEADER_FILE_GUARD
+
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace ink {
+	
+	/**
+	 * Per-thread free lists of coroutine frames, one per size class of GRANULE bytes, refilled by carving CHUNK-byte
+	 * chunks; frames past the largest class go to ::operator new. Allocating and freeing a frame is a pop and a push,
+	 * and the frames of many tasks of the same coroutine end up side by side, in the order they were made.
+	 *
+	 * The pool lives for as long as any of its frames does, past the end of its thread if need be: e.g. the frames of a
+	 * StateScheduler at namespace scope, destroyed after the thread_locals of the main thread, are still given back to
+	 * it, and the last of them deletes it. The free lists are not shared, however, so every frame must be destroyed on
+	 * the thread that made it; a StateScheduler, which is not shared between threads, sees to that.
+	 */
+	class FramePool {
+		
+		public: static constexpr size_t
+		GRANULE = 64;
+		
+		public: static constexpr size_t
+		CLASSES = 16;
+		
+		public: static constexpr size_t
+		CHUNK = size_t(1) << 16;
+		
+		public: static FramePool&
+		Local()
+		{
+			if (local == nullptr) [[unlikely]] Adopt();
+			return *local;
+		}
+		
+		public: void*
+		Allocate(size_t size)
+		{
+			if (size > GRANULE * CLASSES) return ::operator new(size);
+			
+			const size_t size_class = (size - 1) / GRANULE;
+			if (free[size_class] == nullptr) Refill(size_class);
+			
+			Block* block = free[size_class];
+			free[size_class] = block->next;
+			live++;
+			return block;
+		}
+		
+		public: void
+		Deallocate(void* frame, size_t size) noexcept
+		{
+			if (size > GRANULE * CLASSES) return ::operator delete(frame, size);
+			
+			Block* block = static_cast<Block*>(frame);
+			block->next = free[(size - 1) / GRANULE];
+			free[(size - 1) / GRANULE] = block;
+			
+			if (--live == 0 && orphaned) { local = nullptr; delete this; }
+		}
+		
+		// Bytes held in chunks, whether handed out or free.
+		public: size_t
+		Reserved() const
+		{ return chunks.size() * CHUNK; }
+		
+		// Frames handed out from the chunks, and not yet given back.
+		public: size_t
+		Live() const
+		{ return live; }
+		
+		private: struct Block {
+			Block* next;
+		};
+		
+		// Makes the calling thread's pool, to be let go when the thread ends, or with its last frame if any are left then.
+		private: static void
+		Adopt()
+		{
+			struct Owner {
+				~Owner()
+				{
+					if (local->live == 0) { delete local; local = nullptr; }
+					else local->orphaned = true;
+				}
+			};
+			
+			local = new FramePool;
+			thread_local Owner owner;
+		}
+		
+		// Carves a new chunk into blocks of one class, linked in address order.
+		private: void
+		Refill(size_t size_class)
+		{
+			const size_t size = (size_class + 1) * GRANULE;
+			std::byte* chunk = chunks.emplace_back(new std::byte[CHUNK]).get();
+			
+			Block* head = nullptr;
+			for (size_t at = (CHUNK / size) * size; at > 0; at -= size)
+			{
+				Block* block = reinterpret_cast<Block*>(chunk + at - size);
+				block->next = head;
+				head = block;
+			}
+			free[size_class] = head;
+		}
+		
+		private: Block* free[CLASSES] = {};
+		private: std::vector<std::unique_ptr<std::byte[]>> chunks;
+		private: size_t live = 0;			// Frames handed out from the chunks, and not yet given back.
+		private: bool orphaned = false;		// Its thread has ended; the last frame to go deletes it.
+		
+		// Trivially destructible, so still readable while statics are destroyed, after the thread_locals of the main thread.
+		private: static inline thread_local FramePool* local = nullptr;
+		
+	};
+	
+	class StateScheduler;
+	
+	/**
+	 * The return type of a coroutine run by a StateScheduler, e.g. a state of a machine made with MAKE_STATE.hpp, given
+	 * "#define MAKE_STATE_RETURN_TYPE ink::StateTask". It does nothing until spawned; its frame comes from the FramePool
+	 * of the thread that calls it.
+	 */
+	class StateTask {
+		
+		public: struct promise_type {
+			
+			StateScheduler* scheduler = nullptr;
+			
+			StateTask
+			get_return_object()
+			{ return StateTask(std::coroutine_handle<promise_type>::from_promise(*this)); }
+			
+			std::suspend_always
+			initial_suspend() noexcept
+			{ return {}; }
+			
+			// Left suspended when done, for the scheduler to destroy after resume() returns.
+			std::suspend_always
+			final_suspend() noexcept
+			{ return {}; }
+			
+			void
+			return_void()
+			{}
+			
+			// Out of resume(), and so out of StateScheduler::Tick().
+			void
+			unhandled_exception()
+			{ throw; }
+			
+			static void*
+			operator new(size_t size)
+			{ return FramePool::Local().Allocate(size); }
+			
+			static void
+			operator delete(void* frame, size_t size) noexcept
+			{ FramePool::Local().Deallocate(frame, size); }
+			
+		};
+		
+		public: using Handle = std::coroutine_handle<promise_type>;
+		
+		public:
+		StateTask(StateTask&& other) noexcept:
+		handle(std::exchange(other.handle, {}))
+		{}
+		
+		public: StateTask&
+		operator=(StateTask&& other) noexcept
+		{
+			if (this != &other) { if (handle) handle.destroy(); handle = std::exchange(other.handle, {}); }
+			return *this;
+		}
+		
+		public:
+		~StateTask()
+		{ if (handle) handle.destroy(); }
+		
+		// Gives up the frame, which the caller must then destroy.
+		public: Handle
+		Release()
+		{ return std::exchange(handle, {}); }
+		
+		private: explicit
+		StateTask(Handle handle):
+		handle(handle)
+		{}
+		
+		private: Handle handle;
+		
+	};
+	
+	// co_await ink::NextTick{}; suspends until the next StateScheduler::Tick().
+	struct NextTick {
+		
+		bool
+		await_ready() const noexcept
+		{ return false; }
+		
+		void
+		await_suspend(StateTask::Handle task) const;
+		
+		void
+		await_resume() const noexcept
+		{}
+		
+	};
+	
+	// co_await ink::WaitFor{ event }; suspends until the tick after StateScheduler::Signal(event).
+	struct WaitFor {
+		
+		uint32_t event;
+		
+		bool
+		await_ready() const noexcept
+		{ return false; }
+		
+		void
+		await_suspend(StateTask::Handle task) const;
+		
+		void
+		await_resume() const noexcept
+		{}
+		
+	};
+	
+	/**
+	 * Runs StateTasks a tick at a time: each Tick() resumes, in one batch and in order, every task that was spawned,
+	 * that awaited NextTick, or whose event was signalled, since the last one. The basic, raw intended usage is as displayed:
+	 *
+	 * 	...
+	 * 	#define MAKE_STATE(v) v(Walk) v(Rest)
+	 * 	#define MAKE_STATE_RETURN_TYPE ink::StateTask
+	 * 	#define MAKE_STATE_PARAMETERS Actor& actor
+	 * 	#define MAKE_STATE_ARGUMENTS actor
+	 * 	#include "MAKE_STATE.hpp"
+	 *
+	 * 	ink::StateTask Walk(Actor& actor) {
+	 * 		for (int step = 0; step < 8; step++) { if (step > 0) co_await ink::NextTick{}; actor.x++; }
+	 * 		ink::StateScheduler::Current()->Spawn(RunState(State::Rest, actor));	// The next state, from the next tick.
+	 * 	}
+	 *
+	 * 	ink::StateScheduler scheduler;
+	 * 	for (Actor& actor : actors) scheduler.Spawn(RunState(State::Walk, actor));
+	 * 	while (Running) scheduler.Tick();
+	 * 	...
+	 *
+	 * A task's progress is where it is suspended, so it keeps no counters of its own. Tasks are destroyed as they finish,
+	 * and the scheduler destroys whatever is left when it is. Not thread-safe: one scheduler per thread.
+	 */
+	class StateScheduler {
+		
+		public: StateScheduler() = default;
+		public: StateScheduler(StateScheduler const&) = delete;
+		public: StateScheduler& operator=(StateScheduler const&) = delete;
+		
+		public:
+		~StateScheduler()
+		{
+			for (auto task : ready) task.destroy();
+			for (auto const& waiters : waiting) for (auto task : waiters) task.destroy();
+		}
+		
+		// The scheduler whose Tick() is running on this thread; nullptr outside of any.
+		public: static StateScheduler*
+		Current()
+		{ return current; }
+		
+		// Takes task over, to be first resumed at the next Tick().
+		public: void
+		Spawn(StateTask task)
+		{
+			StateTask::Handle handle = task.Release();
+			handle.promise().scheduler = this;
+			ready.push_back(handle);
+			live++;
+		}
+		
+		/**
+		 * Resumes every task due this tick, and returns how many. An exception out of a task destroys it, and leaves
+		 * the tasks after it due for the next tick.
+		 */
+		public: size_t
+		Tick()
+		{
+			running.swap(ready);
+			StateScheduler* const outer = std::exchange(current, this);
+			
+			size_t i = 0;
+			try
+			{
+				for (; i < running.size(); i++)
+				{
+					running[i].resume();
+					if (running[i].done()) { running[i].destroy(); live--; }
+				}
+			}
+			catch (...)
+			{
+				running[i].destroy(); live--;
+				ready.insert(ready.begin(), running.begin() + i + 1, running.end());
+				running.clear();
+				current = outer;
+				throw;
+			}
+			
+			const size_t resumed = running.size();
+			running.clear();
+			current = outer;
+			return resumed;
+		}
+		
+		// Makes every task waiting for event due at the next Tick(), and returns how many.
+		public: size_t
+		Signal(uint32_t event)
+		{
+			if (event >= waiting.size()) return 0;
+			auto& waiters = waiting[event];
+			const size_t signalled = waiters.size();
+			ready.insert(ready.end(), waiters.begin(), waiters.end());
+			waiters.clear();
+			return signalled;
+		}
+		
+		// Tasks spawned and not yet finished.
+		public: size_t
+		Size() const
+		{ return live; }
+		
+		private: friend struct NextTick;
+		private: friend struct WaitFor;
+		
+		private: std::vector<std::coroutine_handle<>> ready;		// Due at the next Tick().
+		private: std::vector<std::coroutine_handle<>> running;		// Being resumed by this one; kept to reuse its storage.
+		private: std::vector<std::vector<std::coroutine_handle<>>> waiting;	// Per event, grown to the largest one waited on.
+		private: size_t live = 0;
+		
+		private: static inline thread_local StateScheduler* current = nullptr;
+		
+	};
+	
+	inline void
+	NextTick::await_suspend(StateTask::Handle task) const
+	{ task.promise().scheduler->ready.push_back(task); }
+	
+	inline void
+	WaitFor::await_suspend(StateTask::Handle task) const
+	{
+		auto& waiting = task.promise().scheduler->waiting;
+		if (event >= waiting.size()) waiting.resize(size_t(event) + 1);
+		waiting[event].push_back(task);
+	}
+	
+}
+
+#endif
@@ -0,0 +1,405 @@
+#ifndef INK_UTILITY_STATE_TRACE_HEADER_FILE_GUARD
+#define INK_UTILITY_STATE_TRACE_HEADER_FILE_GUARD
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+// Events kept per thread, a power of two; past that, the oldest are overwritten.
+#if !defined(INK_STATE_TRACE_RING)
+	#define INK_STATE_TRACE_RING (1 << 15)
+#endif
+
+// States counted per thread, over every traced machine; states past it are still traced, but not counted.
+#if !defined(INK_STATE_TRACE_MAX_STATES)
+	#define INK_STATE_TRACE_MAX_STATES 1024
+#endif
+
+namespace ink {
+	
+	/**
+	 * Records of every RunState call made by state machines built with MAKE_STATE_TRACE defined (see MAKE_STATE.hpp):
+	 * when it started, the state it ran, the state the same thread ran before it on the same machine, and how long it took.
+	 *
+	 * Each thread writes into its own ring of the latest INK_STATE_TRACE_RING events, and into its own counters; a call
+	 * costs two clock reads and a handful of relaxed stores, with no lock and nothing shared between threads. Any thread
+	 * may read while others write:
+	 *
+	 * 	...
+	 * 	const auto counters = ink::StateTrace::Counters(State::Walk);	// Summed over every thread.
+	 * 	printf("Walk: %llu calls, %lld ns at most\n", counters.calls, counters.max.count());
+	 * 	...
+	 * 	ink::StateTrace::Dump("states.trace");	// Compact binary, 24 bytes per event.
+	 * 	ink::StateTrace::ToChromeTrace("states.trace", "states.json");	// For chrome://tracing, or ui.perfetto.dev.
+	 * 	ink::StateTrace::ReleaseFinished();	// Frees what ended threads left behind.
+	 * 	...
+	 *
+	 * Without MAKE_STATE_TRACE, nothing of this is compiled into RunState at all.
+	 */
+	class StateTrace {
+		
+		public: using SC = std::chrono::steady_clock;
+		
+		// Aggregates of one state, over every thread.
+		public: struct StateCounters {
+			uint64_t calls = 0;
+			std::chrono::nanoseconds total{};
+			std::chrono::nanoseconds max{};
+		};
+		
+		// Marks "no previous state": the first call of a machine on a thread.
+		public: static constexpr uint32_t
+		NONE = 0xFFFF;
+		
+		// A registered machine: its id, and the index of its first state among every machine's counters.
+		public: struct Machine {
+			uint32_t id, base;
+		};
+		
+		/**
+		 * Registers a machine and the names of its states, in enum order, once per enum type; later calls return the same id.
+		 * The generated RunState calls this on its first run.
+		 */
+		public: template<typename Enum> static Machine
+		Register(std::string_view name, std::initializer_list<std::string_view> states)
+		{
+			static const Machine machine = [&] {
+				std::lock_guard lock(Registry().mutex);
+				auto& machines = Registry().machines;
+				const uint32_t base = machines.empty() ? 0 : machines.back().base + uint32_t(machines.back().states.size());
+				machines.push_back(MachineInfo{ std::string(name), std::vector<std::string>(states.begin(), states.end()), base });
+				const uint32_t id = uint32_t(machines.size() - 1);
+				machine_of<Enum>.store(id, std::memory_order_release);
+				return Machine{ id, base };
+			}();
+			return machine;
+		}
+		
+		private: struct ThreadLog;
+		
+		/**
+		 * Times one call, from construction to destruction, and records it. Made by the generated RunState; previous is
+		 * updated to state.
+		 */
+		public: class Scope {
+			
+			public:
+			Scope(Machine machine, uint32_t& previous, uint32_t state):
+			log(Local()), machine(machine), from(previous), to(state), start(SC::now())
+			{ previous = state; }
+			
+			public: Scope(Scope const&) = delete;
+			public: Scope& operator=(Scope const&) = delete;
+			
+			public:
+			~Scope()
+			{ log.Record(machine, from, to, start, SC::now()); }
+			
+			private: ThreadLog& log;		// Looked up before the clock starts, so a thread's first call is not charged for making it.
+			private: Machine machine;
+			private: uint32_t from, to;
+			private: SC::time_point start;
+			
+		};
+		
+		// Counters of state, over every thread; all zero until its machine's first RunState.
+		public: template<typename Enum> requires std::is_enum_v<Enum> static StateCounters
+		Counters(Enum state)
+		{
+			const uint32_t machine = machine_of<Enum>.load(std::memory_order_acquire);
+			if (machine == NONE) return {};
+			return Counters(machine, uint32_t(static_cast<std::underlying_type_t<Enum>>(state)));
+		}
+		
+		// Counters of a state of a registered machine, over every thread; all zero if there is no such machine or state.
+		public: static StateCounters
+		Counters(uint32_t machine, uint32_t state)
+		{
+			std::lock_guard lock(Registry().mutex);
+			StateCounters out;
+			if (machine >= Registry().machines.size() || state >= Registry().machines[machine].states.size()) return out;
+			
+			const uint32_t slot = Registry().machines[machine].base + state;
+			if (slot >= INK_STATE_TRACE_MAX_STATES) return out;
+			for (auto const& log : Registry().logs)
+			{
+				auto const& counter = log->counters[slot];
+				out.calls += counter.calls.load(std::memory_order_relaxed);
+				out.total += std::chrono::nanoseconds(counter.total.load(std::memory_order_relaxed));
+				out.max = std::max(out.max, std::chrono::nanoseconds(counter.max.load(std::memory_order_relaxed)));
+			}
+			return out;
+		}
+		
+		/**
+		 * Writes every event still in every thread's ring to a binary file, and returns how many; 0 if it cannot be written.
+		 * Threads may keep tracing meanwhile: an event overwritten while being copied is left out, never torn.
+		 *
+		 * The file is, in native byte order: the magic "INKTRACE"; a u32 machine count, then each machine's name and u32
+		 * state count, and each state's name, every name a u32 length and its bytes; a u32 thread count, then for each
+		 * thread a u64 event count, and its events, oldest first, each 3 u64: start (ns, steady clock), duration (ns), and
+		 * machine << 32 | previous << 16 | state.
+		 */
+		public: static size_t
+		Dump(std::string const& path)
+		{
+			std::unique_ptr<std::FILE, int(*)(std::FILE*)> file(std::fopen(path.c_str(), "wb"), &std::fclose);
+			if (!file) return 0;
+			
+			std::lock_guard lock(Registry().mutex);
+			auto const& machines = Registry().machines;
+			auto const& logs = Registry().logs;
+			
+			std::fwrite("INKTRACE", 1, 8, file.get());
+			Write32(file.get(), uint32_t(machines.size()));
+			for (auto const& machine : machines)
+			{
+				WriteString(file.get(), machine.name);
+				Write32(file.get(), uint32_t(machine.states.size()));
+				for (auto const& state : machine.states) WriteString(file.get(), state);
+			}
+			
+			size_t written = 0;
+			Write32(file.get(), uint32_t(logs.size()));
+			for (auto const& log : logs)
+			{
+				const std::vector<Event> events = log->Snapshot();
+				const uint64_t count = events.size();
+				std::fwrite(&count, sizeof(count), 1, file.get());
+				std::fwrite(events.data(), sizeof(Event), events.size(), file.get());
+				written += events.size();
+			}
+			
+			return std::ferror(file.get()) ? 0 : written;
+		}
+		
+		/**
+		 * Frees the ring and counters of every thread that has ended, typically once they are dumped, and returns how many.
+		 * Their events leave later dumps, and their calls leave the counters; those of running threads are kept.
+		 */
+		public: static size_t
+		ReleaseFinished()
+		{
+			std::lock_guard lock(Registry().mutex);
+			// A running thread's log is also held by its thread_local; past the thread's end, only the registry holds it.
+			return std::erase_if(Registry().logs, [](auto const& log) { return log.use_count() == 1; });
+		}
+		
+		/**
+		 * Converts a file written by Dump() to the Chrome trace event format: one complete ("X") event per call, named
+		 * "Machine::State", on a track per thread, with the previous state as an argument. Returns false if the binary file
+		 * cannot be read, or is not one, or the JSON file cannot be written.
+		 */
+		public: static bool
+		ToChromeTrace(std::string const& binary_path, std::string const& json_path)
+		{
+			std::unique_ptr<std::FILE, int(*)(std::FILE*)> in(std::fopen(binary_path.c_str(), "rb"), &std::fclose);
+			if (!in) return false;
+			
+			char magic[8] = {};
+			if (std::fread(magic, 1, 8, in.get()) != 8 || std::string_view(magic, 8) != "INKTRACE") return false;
+			
+			std::vector<std::string> machine_names;
+			std::vector<std::vector<std::string>> state_names;
+			uint32_t machine_count = 0;
+			if (!Read32(in.get(), machine_count)) return false;
+			for (uint32_t m = 0; m < machine_count; m++)
+			{
+				uint32_t state_count = 0;
+				machine_names.emplace_back();
+				state_names.emplace_back();
+				if (!ReadString(in.get(), machine_names.back()) || !Read32(in.get(), state_count)) return false;
+				state_names.back().resize(state_count);
+				for (auto& name : state_names.back()) if (!ReadString(in.get(), name)) return false;
+			}
+			
+			std::unique_ptr<std::FILE, int(*)(std::FILE*)> out(std::fopen(json_path.c_str(), "w"), &std::fclose);
+			if (!out) return false;
+			
+			const auto name = [&](uint32_t machine, uint32_t state) -> std::string_view {
+				if (state == NONE) return "(none)";
+				if (machine >= state_names.size() || state >= state_names[machine].size()) return "(unknown)";
+				return state_names[machine][state];
+			};
+			
+			std::fprintf(out.get(), "{\"traceEvents\":[");
+			bool first = true;
+			uint32_t thread_count = 0;
+			if (!Read32(in.get(), thread_count)) return false;
+			for (uint32_t t = 0; t < thread_count; t++)
+			{
+				uint64_t count = 0;
+				if (std::fread(&count, sizeof(count), 1, in.get()) != 1) return false;
+				for (uint64_t e = 0; e < count; e++)
+				{
+					Event event;
+					if (std::fread(&event, sizeof(event), 1, in.get()) != 1) return false;
+					
+					const uint32_t machine = uint32_t(event.ids >> 32), from = (event.ids >> 16) & 0xFFFF, to = event.ids & 0xFFFF;
+					const std::string_view machine_name = machine < machine_names.size() ? std::string_view(machine_names[machine]) : "(unknown)";
+					const std::string_view to_name = name(machine, to), from_name = name(machine, from);
+					std::fprintf(out.get(), "%s\n{\"name\":\"%.*s::%.*s\",\"cat\":\"%.*s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":0,\"tid\":%u,\"args\":{\"from\":\"%.*s\"}}",
+						first ? "" : ",",
+						int(machine_name.size()), machine_name.data(), int(to_name.size()), to_name.data(),
+						int(machine_name.size()), machine_name.data(),
+						double(event.start) / 1000.0, double(event.duration) / 1000.0, t,
+						int(from_name.size()), from_name.data());
+					first = false;
+				}
+			}
+			std::fprintf(out.get(), "\n],\"displayTimeUnit\":\"ns\"}\n");
+			return !std::ferror(out.get());
+		}
+		
+		// One call, as stored and dumped.
+		private: struct Event {
+			uint64_t start;			// ns, steady clock.
+			uint64_t duration;		// ns.
+			uint64_t ids;			// machine << 32 | previous << 16 | state.
+		};
+		
+		// Single-writer counters; relaxed loads and stores, as only the owning thread ever writes them.
+		private: struct Counter {
+			std::atomic<uint64_t> calls{0}, total{0}, max{0};
+		};
+		
+		// One thread's ring and counters; kept alive by the registry past the thread's end, so they can still be dumped, until
+		// ReleaseFinished().
+		private: struct ThreadLog {
+			
+			static constexpr uint64_t MASK = INK_STATE_TRACE_RING - 1;
+			static_assert((INK_STATE_TRACE_RING & MASK) == 0, "INK_STATE_TRACE_RING must be a power of two");
+			
+			// Each event as three relaxed atomics, so that a concurrent Snapshot() is a race on nothing.
+			std::unique_ptr<std::array<std::atomic<uint64_t>, 3>[]> ring{ new std::array<std::atomic<uint64_t>, 3>[INK_STATE_TRACE_RING]{} };
+			std::atomic<uint64_t> head{0};		// Events written, ever; the next goes to ring[head & MASK].
+			std::array<Counter, INK_STATE_TRACE_MAX_STATES> counters{};
+			
+			void
+			Record(Machine machine, uint32_t from, uint32_t to, SC::time_point start, SC::time_point stop)
+			{
+				const uint64_t duration = uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count());
+				const uint64_t begin = uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(start.time_since_epoch()).count());
+				const uint64_t states = uint64_t(machine.id) << 32 | uint64_t(from & 0xFFFF) << 16 | (to & 0xFFFF);
+				
+				const uint64_t h = head.load(std::memory_order_relaxed);
+				auto& slot = ring[h & MASK];
+				
+				// Seqlock style: a Snapshot() that sees any of the stores below, once past its acquire fence, also sees head at
+				// h at least (from the previous call's release), and so drops event h - RING, which they overwrite. Without the
+				// fence, weakly ordered CPUs (e.g. ARM) could make them visible before that, leaving a torn event in the copy.
+				std::atomic_thread_fence(std::memory_order_release);
+				slot[0].store(begin, std::memory_order_relaxed);
+				slot[1].store(duration, std::memory_order_relaxed);
+				slot[2].store(states, std::memory_order_relaxed);
+				head.store(h + 1, std::memory_order_release);
+				
+				const uint32_t index = machine.base + to;
+				if (index < INK_STATE_TRACE_MAX_STATES)
+				{
+					Counter& counter = counters[index];
+					counter.calls.store(counter.calls.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+					counter.total.store(counter.total.load(std::memory_order_relaxed) + duration, std::memory_order_relaxed);
+					if (duration > counter.max.load(std::memory_order_relaxed)) counter.max.store(duration, std::memory_order_relaxed);
+				}
+			}
+			
+			// Every event still in the ring, oldest first, leaving out any that were overwritten while being copied.
+			std::vector<Event>
+			Snapshot() const
+			{
+				const uint64_t end = head.load(std::memory_order_acquire);
+				uint64_t begin = end > INK_STATE_TRACE_RING ? end - INK_STATE_TRACE_RING : 0;
+				
+				std::vector<Event> out;
+				out.reserve(end - begin);
+				for (uint64_t i = begin; i < end; i++)
+				{
+					auto const& slot = ring[i & MASK];
+					out.push_back(Event{ slot[0].load(std::memory_order_relaxed), slot[1].load(std::memory_order_relaxed), slot[2].load(std::memory_order_relaxed) });
+				}
+				
+				// The writer may have lapped the copy; whatever it may have been rewriting by now is dropped.
+				std::atomic_thread_fence(std::memory_order_acquire);
+				const uint64_t now = head.load(std::memory_order_relaxed);
+				if (now + 1 > begin + INK_STATE_TRACE_RING)
+				{
+					const uint64_t valid = std::min(now + 1 - INK_STATE_TRACE_RING, end);
+					out.erase(out.begin(), out.begin() + (valid - begin));
+				}
+				return out;
+			}
+			
+		};
+		
+		private: struct MachineInfo {
+			std::string name;
+			std::vector<std::string> states;
+			uint32_t base;		// Index of its first state among every machine's counters.
+		};
+		
+		private: struct RegistryData {
+			std::mutex mutex;
+			std::vector<MachineInfo> machines;
+			std::vector<std::shared_ptr<ThreadLog>> logs;
+		};
+		
+		private: static RegistryData&
+		Registry()
+		{
+			static RegistryData registry;
+			return registry;
+		}
+		
+		private: static ThreadLog&
+		Local()
+		{
+			thread_local const std::shared_ptr<ThreadLog> log = [] {
+				auto created = std::make_shared<ThreadLog>();
+				std::lock_guard lock(Registry().mutex);
+				Registry().logs.push_back(created);
+				return created;
+			}();
+			return *log;
+		}
+		
+		// Id of the machine registered for each enum type, once it is.
+		private: template<typename Enum> static inline std::atomic<uint32_t>
+		machine_of{ NONE };
+		
+		private: static void
+		Write32(std::FILE* file, uint32_t value)
+		{ std::fwrite(&value, sizeof(value), 1, file); }
+		
+		private: static void
+		WriteString(std::FILE* file, std::string const& s)
+		{ Write32(file, uint32_t(s.size())); std::fwrite(s.data(), 1, s.size(), file); }
+		
+		private: static bool
+		Read32(std::FILE* file, uint32_t& value)
+		{ return std::fread(&value, sizeof(value), 1, file) == 1; }
+		
+		private: static bool
+		ReadString(std::FILE* file, std::string& s)
+		{
+			uint32_t size = 0;
+			if (!Read32(file, size)) return false;
+			s.resize(size);
+			return std::fread(s.data(), 1, size, file) == size;
+		}
+		
+	};
+	
+}
+
+#endif
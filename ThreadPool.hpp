@@ -0,0 +1,226 @@
+#ifndef INK_UTILITY_THREAD_POOL_HEADER_FILE_GUARD
+#define INK_UTILITY_THREAD_POOL_HEADER_FILE_GUARD
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace ink {
+	
+	/**
+	 * A fixed set of worker threads, started once and reused, running batches of numbered tasks:
+	 *
+	 * 	ink::ThreadPool& pool = ink::ThreadPool::Shared();
+	 * 	pool.Run(blocks.size(), [&](size_t b) { Process(blocks[b]); });
+	 *
+	 * Run() deals the tasks out as one contiguous range per thread, the calling thread included, and returns once every
+	 * task has run. A thread that runs out steals half of what is left of another's range, so uneven tasks still keep every
+	 * thread busy, while a thread that is not robbed walks its own range in order. Each range is a single atomic word
+	 * (begin and end, 32 bits each); taking a task, or stealing, is one compare-and-swap, and nothing ever locks.
+	 *
+	 * Run() called from inside a task (of any pool) runs its tasks inline, on that thread, rather than deadlocking.
+	 * Calls from several outside threads at once take turns. If a task throws, the remaining tasks are skipped, and the
+	 * first exception is rethrown from Run().
+	 */
+	class ThreadPool {
+		
+		/**
+		 * @param threads Threads to run tasks on, the one calling Run() included; so threads - 1 workers are started.
+		 * 0 picks std::thread::hardware_concurrency().
+		 */
+		public: explicit
+		ThreadPool(size_t threads = 0):
+		slots(std::max<size_t>(threads ? threads : std::thread::hardware_concurrency(), 1))
+		{
+			workers.reserve(slots.size() - 1);
+			for (size_t w = 1; w < slots.size(); w++) workers.emplace_back([this, w] { Work(w); });
+		}
+		
+		public: ThreadPool(ThreadPool const&) = delete;
+		public: ThreadPool& operator=(ThreadPool const&) = delete;
+		
+		public:
+		~ThreadPool()
+		{
+			stopping.store(true, std::memory_order_relaxed);
+			generation.fetch_add(1, std::memory_order_release);
+			generation.notify_all();
+			for (auto& worker : workers) worker.join();
+		}
+		
+		// The pool shared by everything that does not bring its own, with one thread per hardware thread. Started on first use.
+		public: static ThreadPool&
+		Shared()
+		{
+			static ThreadPool pool;
+			return pool;
+		}
+		
+		// Number of threads tasks are run on, the calling thread included.
+		public: size_t
+		Size() const
+		{ return slots.size(); }
+		
+		/**
+		 * Calls task(t) once for every t in [0, tasks), spread over every thread of the pool, and returns once all are done.
+		 * At most 2^32 - 1 tasks per call.
+		 */
+		public: template<typename Task> void
+		Run(size_t tasks, Task&& task)
+		{
+			if (tasks == 0) return;
+			if (tasks == 1 || slots.size() == 1 || running_in != nullptr)
+			{
+				for (size_t t = 0; t < tasks; t++) task(t);
+				return;
+			}
+			
+			std::lock_guard lock(run_mutex);
+			
+			job = Job{ &Call<std::remove_reference_t<Task>>, const_cast<void*>(static_cast<void const*>(std::addressof(task))) };
+			failure = nullptr;
+			failed.store(false, std::memory_order_relaxed);
+			
+			const size_t n = slots.size();
+			for (size_t s = 0; s < n; s++) slots[s].range.store(Pack(tasks * s / n, tasks * (s + 1) / n), std::memory_order_relaxed);
+			
+			pending.store(n - 1, std::memory_order_relaxed);
+			generation.fetch_add(1, std::memory_order_release);
+			generation.notify_all();
+			
+			Participate(0);
+			
+			for (size_t left; (left = pending.load(std::memory_order_acquire)) != 0;) pending.wait(left, std::memory_order_acquire);
+			
+			if (failure) std::rethrow_exception(failure);
+		}
+		
+		// A task, type-erased without allocating: the callable stays on the stack of Run().
+		private: struct Job {
+			void (*call)(void*, size_t) = nullptr;
+			void* task = nullptr;
+		};
+		
+		// One thread's share of the current job, [begin, end) packed into one word. Kept to a cache line each, as every thread polls them.
+		private: struct alignas(64) Slot {
+			std::atomic<uint64_t> range{0};
+		};
+		
+		private: template<typename Task> static void
+		Call(void* task, size_t t)
+		{ (*static_cast<Task*>(task))(t); }
+		
+		private: static constexpr uint64_t
+		Pack(uint64_t begin, uint64_t end)
+		{ return begin << 32 | end; }
+		
+		private: void
+		Work(size_t slot)
+		{
+			uint64_t seen = 0;
+			while (true)
+			{
+				generation.wait(seen, std::memory_order_acquire);
+				seen = generation.load(std::memory_order_acquire);
+				if (stopping.load(std::memory_order_relaxed)) return;
+				
+				Participate(slot);
+				
+				if (pending.fetch_sub(1, std::memory_order_acq_rel) == 1) pending.notify_one();
+			}
+		}
+		
+		// Runs tasks from this thread's own range, then from whichever others have some left, until none do.
+		private: void
+		Participate(size_t slot)
+		{
+			running_in = this;
+			
+			const size_t n = slots.size();
+			std::atomic<uint64_t>& own = slots[slot].range;
+			
+			while (true)
+			{
+				// Own range, from the front.
+				for (uint64_t r = own.load(std::memory_order_acquire); uint32_t(r >> 32) < uint32_t(r);)
+				{
+					if (own.compare_exchange_weak(r, r + (uint64_t(1) << 32), std::memory_order_acq_rel)) { Execute(r >> 32); r = own.load(std::memory_order_acquire); }
+				}
+				
+				// Steal the back half of the first range that has anything left; the first of those tasks is run right away.
+				bool stole = false;
+				for (size_t v = 1; v < n && !stole; v++)
+				{
+					std::atomic<uint64_t>& victim = slots[(slot + v) % n].range;
+					for (uint64_t r = victim.load(std::memory_order_acquire); uint32_t(r >> 32) < uint32_t(r);)
+					{
+						const uint64_t begin = r >> 32, end = uint32_t(r), middle = begin + (end - begin) / 2;
+						if (victim.compare_exchange_weak(r, Pack(begin, middle), std::memory_order_acq_rel))
+						{
+							own.store(Pack(middle + 1, end), std::memory_order_release);
+							Execute(middle);
+							stole = true;
+							break;
+						}
+					}
+				}
+				if (!stole) break;
+			}
+			
+			running_in = nullptr;
+		}
+		
+		private: void
+		Execute(size_t t)
+		{
+			if (failed.load(std::memory_order_relaxed)) return;
+			try { job.call(job.task, t); }
+			catch (...)
+			{
+				if (!failed.exchange(true, std::memory_order_acq_rel)) failure = std::current_exception();
+			}
+		}
+		
+		private: std::vector<Slot>
+		slots;
+		
+		private: std::vector<std::thread>
+		workers;
+		
+		private: Job
+		job;
+		
+		private: std::exception_ptr
+		failure;
+		
+		private: std::mutex
+		run_mutex;
+		
+		// Bumped to start every job, and once more to stop; the workers sleep on it in between.
+		private: alignas(64) std::atomic<uint64_t>
+		generation{0};
+		
+		// Workers still inside the current job; Run() sleeps on it.
+		private: alignas(64) std::atomic<size_t>
+		pending{0};
+		
+		private: std::atomic<bool>
+		failed{false},
+		stopping{false};
+		
+		// The pool whose task this thread is running, if any; Run() from inside a task runs inline.
+		private: static inline thread_local ThreadPool const*
+		running_in = nullptr;
+		
+	};
+	
+}
+
+#endif
@@ -1,10 +1,12 @@
 #ifndef INK_UTILITY_2D_VECTOR_CLASS_HEADER_FILE_GUARD
 #define INK_UTILITY_2D_VECTOR_CLASS_HEADER_FILE_GUARD
 
+#include <bit>
 #include <cstdint>
 #include <utility>
 #include <math.h>
 #include <tuple>
+#include <type_traits>
 
 namespace ink {
 	
@@ -17,7 +19,7 @@ namespace ink {
 			
 			// Originally ripped from Stack Overflow, which was a modified version of Quake III's fast reverse square root function.
 			// Set extra_iterations to 1 or more for increased accuracy, at the cost of some loss in efficiency.
-			static inline float Q_rsqrt(T number, size_t extra_iterations) {
+			static constexpr float Q_rsqrt(T number, size_t extra_iterations) {
 				
 				constexpr float THREE_HALVES = 1.5F;
 				constexpr auto MAGIC_NUM = 0x5f3759df;
@@ -27,9 +29,9 @@ namespace ink {
 				
 				x2 = number * 0.5F;
 				y = number;
-				i = *(uint32_t*)&y;
+				i = std::bit_cast<uint32_t>(y);
 				i = MAGIC_NUM - (i >> 1);
-				y = *(float *) &i;
+				y = std::bit_cast<float>(i);
 				
 				y = y * (THREE_HALVES - (x2 * y * y));
 				
@@ -40,7 +42,7 @@ namespace ink {
 				return y;
 			}
 			
-			static inline float Q_rsqrt(T number) {
+			static constexpr float Q_rsqrt(T number) {
 				
 				constexpr float THREE_HALVES = 1.5F;
 				constexpr auto MAGIC_NUM = 0x5f3759df;
@@ -50,9 +52,9 @@ namespace ink {
 				
 				x2 = number * 0.5F;
 				y = number;
-				i = *(uint32_t*)&y;
+				i = std::bit_cast<uint32_t>(y);
 				i = MAGIC_NUM - (i >> 1);
-				y = *(float *) &i;
+				y = std::bit_cast<float>(i);
 				
 				y = y * (THREE_HALVES - (x2 * y * y));
 				
@@ -65,7 +67,7 @@ namespace ink {
 		struct Q_rsqrt_impl<T> {
 			
 			// Set extra_iterations to 1 or more for increased accuracy, at the cost of some loss in efficiency.
-			static inline double Q_rsqrt(T number, size_t extra_iterations) {
+			static constexpr double Q_rsqrt(T number, size_t extra_iterations) {
 				
 				constexpr double THREE_HALVES = 1.5;
 				constexpr auto MAGIC_NUM = 0x5fe6eb50c7b537a9;
@@ -75,9 +77,9 @@ namespace ink {
 				
 				x2 = number * 0.5F;
 				y = number;
-				i = *(uint64_t*)&y;
+				i = std::bit_cast<uint64_t>(y);
 				i = MAGIC_NUM - (i >> 1);
-				y = *(double *) &i;
+				y = std::bit_cast<double>(i);
 				
 				y = y * (THREE_HALVES - (x2 * y * y));
 				
@@ -88,7 +90,7 @@ namespace ink {
 				return y;
 			}
 			
-			static inline double Q_rsqrt(T number) {
+			static constexpr double Q_rsqrt(T number) {
 				
 				constexpr double THREE_HALVES = 1.5;
 				constexpr auto MAGIC_NUM = 0x5fe6eb50c7b537a9;
@@ -98,9 +100,9 @@ namespace ink {
 				
 				x2 = number * 0.5F;
 				y = number;
-				i = *(uint64_t*)&y;
+				i = std::bit_cast<uint64_t>(y);
 				i = MAGIC_NUM - (i >> 1);
-				y = *(double *) &i;
+				y = std::bit_cast<double>(i);
 				
 				y = y * (THREE_HALVES - (x2 * y * y));
 				
@@ -115,14 +117,14 @@ namespace ink {
 	 * An implementation of Quake III's Engine's reverse square root function. Supports floats and doubles.
 	 * Set extra_iterations to 1 or more for increased accuracy, at the cost of some loss in efficiency.
 	 */
-	template<typename T> static inline auto
+	template<typename T> static constexpr auto
 	Q_rsqrt(T number, size_t extra_iterations)
 	{ return detail::Q_rsqrt_impl<T>::Q_rsqrt(number, extra_iterations); }
 	
 	/**
 	 * An implementation of Quake III's Engine's reverse square root function. Supports floats and doubles.
 	 */
-	template<typename T> static inline auto
+	template<typename T> static constexpr auto
 	Q_rsqrt(T number)
 	{ return detail::Q_rsqrt_impl<T>::Q_rsqrt(number); }
 	
@@ -153,6 +155,11 @@ namespace ink {
 			Vector2(x_standard_arg x, y_standard_arg y):
 			x(x), y(y) {}
 			
+			// Evaluates a lazy expression (see lazy()) straight into x and y, one component at a time.
+			public: template<typename E> requires requires { typename E::vector2_expression; } constexpr
+			Vector2(E const& expression):
+			x(expression.x()), y(expression.y()) {}
+			
 			// Returns true if the vector angle pertains to Quadruant 1
 			public: constexpr decltype(auto)
 			quadrant1() const
@@ -376,6 +383,20 @@ namespace ink {
 			
 		};
 		
+		template<typename E> requires requires { typename E::vector2_expression; }
+		Vector2(E const&) -> Vector2<std::remove_cvref_t<decltype(std::declval<E const&>().x())>, std::remove_cvref_t<decltype(std::declval<E const&>().y())>>;
+		
+		// Whether T takes part in Vector2 arithmetic as a whole vector: a Vector2, or anything declaring a vector2_operand type.
+		template<typename T> static constexpr bool
+		is_vector2_operand = requires { typename T::vector2_operand; };
+		
+		template<typename X, typename Y> static constexpr bool
+		is_vector2_operand<Vector2<X, Y>> = true;
+		
+		// Any operand that is applied to both components alike, e.g. a float.
+		template<typename T> concept
+		Vector2Scalar = !is_vector2_operand<std::remove_cvref_t<T>>;
+		
 		template<typename X1, typename Y1 = X1, typename X2 = X1, typename Y2 = Y1> static constexpr auto
 		operator+(Vector2<X1, Y1> const& lhs, Vector2<X2, Y2> const& rhs)
 		requires requires(X1 x1, Y1 y1, X2 x2, Y2 y2)
@@ -386,16 +407,16 @@ namespace ink {
 			return Vector2<decltype(lhs.x + rhs.x), decltype(lhs.y + rhs.y)>(lhs.x + rhs.x, lhs.y + rhs.y);
 		}
 		
-		template<typename T, typename X, typename Y = X> static constexpr auto
+		template<Vector2Scalar T, typename X, typename Y = X> static constexpr auto
 		operator+(T const& lhs, Vector2<X, Y> const& rhs)
 		{
-			return Vector2<T, T>(lhs, lhs) + rhs;
+			return Vector2<decltype(lhs + rhs.x), decltype(lhs + rhs.y)>(lhs + rhs.x, lhs + rhs.y);
 		}
 		
-		template<typename T, typename X, typename Y = X> static constexpr auto
+		template<Vector2Scalar T, typename X, typename Y = X> static constexpr auto
 		operator+(Vector2<X, Y> const& lhs, T const& rhs)
 		{
-			return rhs + lhs;
+			return Vector2<decltype(lhs.x + rhs), decltype(lhs.y + rhs)>(lhs.x + rhs, lhs.y + rhs);
 		}
 		
 		
@@ -412,20 +433,24 @@ namespace ink {
 		
 		template<typename X1, typename Y1 = X1, typename X2 = X1, typename Y2 = Y1> static constexpr auto
 		operator-(Vector2<X1, Y1> const& lhs, Vector2<X2, Y2> const& rhs)
+		requires requires(X1 x1, Y1 y1, X2 x2, Y2 y2)
+		{
+			x1 - x2; y1 - y2;
+		}
 		{
-			return lhs + (-rhs);
+			return Vector2<decltype(lhs.x - rhs.x), decltype(lhs.y - rhs.y)>(lhs.x - rhs.x, lhs.y - rhs.y);
 		}
 		
-		template<typename T, typename X, typename Y> static constexpr auto
+		template<Vector2Scalar T, typename X, typename Y> static constexpr auto
 		operator-(T const& lhs, Vector2<X, Y> const& rhs)
 		{
-			return Vector2<T, T>(lhs, lhs) - rhs;
+			return Vector2<decltype(lhs - rhs.x), decltype(lhs - rhs.y)>(lhs - rhs.x, lhs - rhs.y);
 		}
 		
-		template<typename T, typename X, typename Y> static constexpr auto
+		template<Vector2Scalar T, typename X, typename Y> static constexpr auto
 		operator-(Vector2<X, Y> const& lhs, T const& rhs)
 		{
-			return lhs - Vector2<T, T>(rhs, rhs);
+			return Vector2<decltype(lhs.x - rhs), decltype(lhs.y - rhs)>(lhs.x - rhs, lhs.y - rhs);
 		}
 		
 		
@@ -440,16 +465,16 @@ namespace ink {
 			return Vector2<decltype(lhs.x * rhs.x), decltype(lhs.y * rhs.y)> (lhs.x * rhs.x, lhs.y * rhs.y);
 		}
 		
-		template<typename T, typename X, typename Y = X> static constexpr auto
+		template<Vector2Scalar T, typename X, typename Y = X> static constexpr auto
 		operator*(T const& lhs, Vector2<X, Y> const& rhs)
 		{
 			return Vector2<decltype(lhs * rhs.x), decltype(lhs * rhs.y)>(lhs * rhs.x, lhs * rhs.y);
 		}
 		
-		template<typename T, typename X, typename Y = X> static constexpr auto
+		template<Vector2Scalar T, typename X, typename Y = X> static constexpr auto
 		operator*(Vector2<X, Y> const& lhs, T const& rhs)
 		{
-			return rhs * lhs;
+			return Vector2<decltype(lhs.x * rhs), decltype(lhs.y * rhs)>(lhs.x * rhs, lhs.y * rhs);
 		}
 		
 		
@@ -464,16 +489,16 @@ namespace ink {
 			return Vector2<decltype(lhs.x / rhs.x), decltype(lhs.y / rhs.y)> (lhs.x / rhs.x, lhs.y / rhs.y);
 		}
 		
-		template<typename T, typename X, typename Y = X> static constexpr auto
+		template<Vector2Scalar T, typename X, typename Y = X> static constexpr auto
 		operator/(Vector2<X, Y> const& lhs, T const& rhs)
 		{
-			return lhs / Vector2<T, T>(rhs, rhs);
+			return Vector2<decltype(lhs.x / rhs), decltype(lhs.y / rhs)>(lhs.x / rhs, lhs.y / rhs);
 		}
 		
-		template<typename T, typename X, typename Y = X> static constexpr auto
+		template<Vector2Scalar T, typename X, typename Y = X> static constexpr auto
 		operator/(T const& lhs, Vector2<X, Y> const& rhs)
 		{
-			return Vector2<T, T>(lhs, lhs) / rhs;
+			return Vector2<decltype(lhs / rhs.x), decltype(lhs / rhs.y)>(lhs / rhs.x, lhs / rhs.y);
 		}
 		
 		
@@ -488,16 +513,16 @@ namespace ink {
 			return Vector2<decltype(lhs.x % rhs.x, lhs.y % rhs.y)>(lhs.x % rhs.x, lhs.y % rhs.y);
 		}
 		
-		template<typename T, typename X, typename Y = X> static constexpr auto
+		template<Vector2Scalar T, typename X, typename Y = X> static constexpr auto
 		operator%(Vector2<X, Y> const& lhs, T const& rhs)
 		{
-			return lhs % Vector2<T, T>(rhs, rhs);
+			return Vector2<decltype(lhs.x % rhs), decltype(lhs.y % rhs)>(lhs.x % rhs, lhs.y % rhs);
 		}
 		
-		template<typename T, typename X, typename Y = X> static constexpr auto
+		template<Vector2Scalar T, typename X, typename Y = X> static constexpr auto
 		operator%(T const& lhs, Vector2<X, Y> const& rhs)
 		{
-			return Vector2<T, T>(lhs, lhs) % rhs;
+			return Vector2<decltype(lhs % rhs.x), decltype(lhs % rhs.y)>(lhs % rhs.x, lhs % rhs.y);
 		}
 		
 		
@@ -599,14 +624,24 @@ namespace ink {
 		
 		template<typename X1, typename Y1 = X1, typename X2 = X1, typename Y2 = Y1> static constexpr auto
 		operator>=(Vector2<X1, Y1> const& lhs, Vector2<X2, Y2> const& rhs)
+		requires requires(X1 x1, Y1 y1, X2 x2, Y2 y2)
 		{
-			return (lhs > rhs) || (lhs == rhs);
+			x1 >= x2;
+			y1 >= y2;
+		}
+		{
+			return Vector2<bool>(lhs.x >= rhs.x, lhs.y >= rhs.y);
 		}
 		
 		template<typename X1, typename Y1 = X1, typename X2 = X1, typename Y2 = Y1> static constexpr auto
 		operator<=(Vector2<X1, Y1> const& lhs, Vector2<X2, Y2> const& rhs)
+		requires requires(X1 x1, Y1 y1, X2 x2, Y2 y2)
+		{
+			x1 <= x2;
+			y1 <= y2;
+		}
 		{
-			return (lhs < rhs) || (lhs == rhs);
+			return Vector2<bool>(lhs.x <= rhs.x, lhs.y <= rhs.y);
 		}
 		
 		// Forbidden types. Left undefined, as their implementation is of little use.
@@ -616,9 +651,127 @@ namespace ink {
 		template<typename XT, typename YT> class Vector2<XT const, YT>;
 		template<typename XT, typename YT> class Vector2<XT, YT const>;
 		
+		
+		
+		namespace Vector2Lazy {
+			
+			struct Add { template<typename A, typename B> static constexpr auto apply(A&& a, B&& b) { return std::forward<A>(a) + std::forward<B>(b); } };
+			struct Sub { template<typename A, typename B> static constexpr auto apply(A&& a, B&& b) { return std::forward<A>(a) - std::forward<B>(b); } };
+			struct Mul { template<typename A, typename B> static constexpr auto apply(A&& a, B&& b) { return std::forward<A>(a) * std::forward<B>(b); } };
+			struct Div { template<typename A, typename B> static constexpr auto apply(A&& a, B&& b) { return std::forward<A>(a) / std::forward<B>(b); } };
+			struct Mod { template<typename A, typename B> static constexpr auto apply(A&& a, B&& b) { return std::forward<A>(a) % std::forward<B>(b); } };
+			struct Neg { template<typename A> static constexpr auto apply(A&& a) { return -std::forward<A>(a); } };
+			
+			// A Vector2 operand, read in place.
+			template<typename X, typename Y> struct
+			leaf
+			{
+				using vector2_operand = void;
+				using vector2_expression = void;
+				
+				Vector2<X, Y> const& v;
+				
+				constexpr X const& x() const { return v.x; }
+				constexpr Y const& y() const { return v.y; }
+			};
+			
+			// A scalar operand, standing for both components. Arithmetic values are held by copy, anything else by reference.
+			template<typename T> struct
+			scalar
+			{
+				using vector2_operand = void;
+				using vector2_expression = void;
+				
+				std::conditional_t<std::is_arithmetic_v<T>, T, T const&> v;
+				
+				constexpr T const& x() const { return v; }
+				constexpr T const& y() const { return v; }
+			};
+			
+			// Op applied to the components of two subexpressions. The results of subexpressions are passed on as rvalues,
+			// so element types with move-aware operators reuse them rather than allocating anew.
+			template<typename Op, typename L, typename R> struct
+			binary
+			{
+				using vector2_operand = void;
+				using vector2_expression = void;
+				
+				L l;
+				R r;
+				
+				constexpr auto x() const { return Op::apply(l.x(), r.x()); }
+				constexpr auto y() const { return Op::apply(l.y(), r.y()); }
+			};
+			
+			template<typename Op, typename E> struct
+			unary
+			{
+				using vector2_operand = void;
+				using vector2_expression = void;
+				
+				E e;
+				
+				constexpr auto x() const { return Op::apply(e.x()); }
+				constexpr auto y() const { return Op::apply(e.y()); }
+			};
+			
+			template<typename T> concept
+			Expression = requires { typename std::remove_cvref_t<T>::vector2_expression; };
+			
+			// The node standing for an operand: expressions are nodes already (and only hold references, so are cheap to copy).
+			template<Expression E> static constexpr auto
+			operand(E const& e)
+			{ return e; }
+			
+			template<typename X, typename Y> static constexpr auto
+			operand(Vector2<X, Y> const& v)
+			{ return leaf<X, Y>{ v }; }
+			
+			template<Vector2Scalar T> static constexpr auto
+			operand(T const& s)
+			{ return scalar<T>{ s }; }
+			
+			// Anything that may join a lazy expression: another expression, a Vector2, or a scalar.
+			template<typename T> concept
+			Operand = requires(T const& t) { operand(t); };
+			
+			#define INK_VECTOR2_LAZY_OPERATOR(sym, Op)																				\
+				template<Operand L, Operand R> requires (Expression<L> || Expression<R>) static constexpr auto					\
+				operator sym(L const& lhs, R const& rhs)																		\
+				{ return binary<Op, decltype(operand(lhs)), decltype(operand(rhs))>{ operand(lhs), operand(rhs) }; }
+			
+			INK_VECTOR2_LAZY_OPERATOR(+, Add)
+			INK_VECTOR2_LAZY_OPERATOR(-, Sub)
+			INK_VECTOR2_LAZY_OPERATOR(*, Mul)
+			INK_VECTOR2_LAZY_OPERATOR(/, Div)
+			INK_VECTOR2_LAZY_OPERATOR(%, Mod)
+			
+			#undef INK_VECTOR2_LAZY_OPERATOR
+			
+			template<Expression E> static constexpr auto
+			operator-(E const& e)
+			{ return unary<Neg, E>{ e }; }
+		
+		}
+		
+		/**
+		 * Starts a lazy expression over v. Arithmetic on it (+ - * / % and unary -), with Vector2s, scalars or other lazy
+		 * expressions, builds a tree of operations instead of a Vector2 per step; the tree is evaluated when converted to a
+		 * Vector2, each component in a single pass, with no vectors in between:
+		 *
+		 * 	Vector2 r = ink::lazy(a) * s + b - c;	// r.x = a.x * s + b.x - c.x, and likewise for y.
+		 *
+		 * The tree refers to its operands rather than copying them, so it must be evaluated within the full expression that
+		 * builds it; never keep one in an auto.
+		 */
+		template<typename X, typename Y> static constexpr auto
+		lazy(Vector2<X, Y> const& v)
+		{ return Vector2Lazy::leaf<X, Y>{ v }; }
+	
 	}
 	
 	using detail::Vector2;
+	using detail::lazy;
 	
 }
 
@@ -0,0 +1,944 @@
+#ifndef INK_UTILITY_2D_VECTOR_ARRAY_CLASS_HEADER_FILE_GUARD
+#define INK_UTILITY_2D_VECTOR_ARRAY_CLASS_HEADER_FILE_GUARD
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+#include <type_traits>
+#include <math.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#include <immintrin.h>
+	#define INK_VECTOR2_ARRAY_SSE2
+#endif
+#if defined(__AVX__)
+	#define INK_VECTOR2_ARRAY_AVX
+#endif
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+	#define INK_VECTOR2_ARRAY_X86
+	#if defined(_MSC_VER) && !defined(__clang__)
+		#include <intrin.h>
+		#define INK_VECTOR2_ARRAY_TARGET(isa)
+	#else
+		#define INK_VECTOR2_ARRAY_TARGET(isa) __attribute__((target(isa)))
+	#endif
+#endif
+
+#include "AlignedAllocator.hpp"
+#include "Vector2.hpp"
+
+namespace ink {
+	
+	namespace detail {
+		
+		namespace simd {
+			
+			/**
+			 * A "batch" is a thin wrapper over one SIMD register worth of T. Kernels are written once against this interface,
+			 * and are run with batch<T> over the bulk of an array and with scalar_batch<T> over whatever tail is left.
+			 */
+			template<typename T> struct
+			scalar_batch
+			{
+				using reg = T;
+				static constexpr size_t width = 1;
+				
+				static inline reg load(T const* p)		{ return *p; }
+				static inline void store(T* p, reg r)	{ *p = r; }
+				static inline reg broadcast(T v)		{ return v; }
+				
+				static inline reg add(reg a, reg b)		{ return a + b; }
+				static inline reg sub(reg a, reg b)		{ return a - b; }
+				static inline reg mul(reg a, reg b)		{ return a * b; }
+				static inline reg div(reg a, reg b)		{ return a / b; }
+				static inline reg sqrt(reg a)			{ return std::sqrt(a); }
+				
+				// Returns value where test is non-zero, and zero elsewhere.
+				static inline reg mask_nonzero(reg test, reg value)
+				{ return test != 0 ? value : reg(0); }
+				
+				// Returns value where test is not NaN, and zero elsewhere.
+				static inline reg mask_not_nan(reg test, reg value)
+				{ return isnan(test) ? reg(0) : value; }
+			};
+			
+			// Primary template; no vector register available for T.
+			template<typename T> struct
+			batch: scalar_batch<T>
+			{};
+			
+			#if defined(INK_VECTOR2_ARRAY_AVX)
+			
+			template<> struct
+			batch<float>
+			{
+				using reg = __m256;
+				static constexpr size_t width = 8;
+				
+				static inline reg load(float const* p)		{ return _mm256_loadu_ps(p); }
+				static inline void store(float* p, reg r)	{ _mm256_storeu_ps(p, r); }
+				static inline reg broadcast(float v)		{ return _mm256_set1_ps(v); }
+				
+				static inline reg add(reg a, reg b)			{ return _mm256_add_ps(a, b); }
+				static inline reg sub(reg a, reg b)			{ return _mm256_sub_ps(a, b); }
+				static inline reg mul(reg a, reg b)			{ return _mm256_mul_ps(a, b); }
+				static inline reg div(reg a, reg b)			{ return _mm256_div_ps(a, b); }
+				static inline reg sqrt(reg a)				{ return _mm256_sqrt_ps(a); }
+				
+				static inline reg mask_nonzero(reg test, reg value)
+				{ return _mm256_and_ps(_mm256_cmp_ps(test, _mm256_setzero_ps(), _CMP_NEQ_UQ), value); }
+				
+				static inline reg mask_not_nan(reg test, reg value)
+				{ return _mm256_and_ps(_mm256_cmp_ps(test, test, _CMP_ORD_Q), value); }
+			};
+			
+			template<> struct
+			batch<double>
+			{
+				using reg = __m256d;
+				static constexpr size_t width = 4;
+				
+				static inline reg load(double const* p)		{ return _mm256_loadu_pd(p); }
+				static inline void store(double* p, reg r)	{ _mm256_storeu_pd(p, r); }
+				static inline reg broadcast(double v)		{ return _mm256_set1_pd(v); }
+				
+				static inline reg add(reg a, reg b)			{ return _mm256_add_pd(a, b); }
+				static inline reg sub(reg a, reg b)			{ return _mm256_sub_pd(a, b); }
+				static inline reg mul(reg a, reg b)			{ return _mm256_mul_pd(a, b); }
+				static inline reg div(reg a, reg b)			{ return _mm256_div_pd(a, b); }
+				static inline reg sqrt(reg a)				{ return _mm256_sqrt_pd(a); }
+				
+				static inline reg mask_nonzero(reg test, reg value)
+				{ return _mm256_and_pd(_mm256_cmp_pd(test, _mm256_setzero_pd(), _CMP_NEQ_UQ), value); }
+				
+				static inline reg mask_not_nan(reg test, reg value)
+				{ return _mm256_and_pd(_mm256_cmp_pd(test, test, _CMP_ORD_Q), value); }
+			};
+			
+			#elif defined(INK_VECTOR2_ARRAY_SSE2)
+			
+			template<> struct
+			batch<float>
+			{
+				using reg = __m128;
+				static constexpr size_t width = 4;
+				
+				static inline reg load(float const* p)		{ return _mm_loadu_ps(p); }
+				static inline void store(float* p, reg r)	{ _mm_storeu_ps(p, r); }
+				static inline reg broadcast(float v)		{ return _mm_set1_ps(v); }
+				
+				static inline reg add(reg a, reg b)			{ return _mm_add_ps(a, b); }
+				static inline reg sub(reg a, reg b)			{ return _mm_sub_ps(a, b); }
+				static inline reg mul(reg a, reg b)			{ return _mm_mul_ps(a, b); }
+				static inline reg div(reg a, reg b)			{ return _mm_div_ps(a, b); }
+				static inline reg sqrt(reg a)				{ return _mm_sqrt_ps(a); }
+				
+				static inline reg mask_nonzero(reg test, reg value)
+				{ return _mm_and_ps(_mm_cmpneq_ps(test, _mm_setzero_ps()), value); }
+				
+				static inline reg mask_not_nan(reg test, reg value)
+				{ return _mm_and_ps(_mm_cmpord_ps(test, test), value); }
+			};
+			
+			template<> struct
+			batch<double>
+			{
+				using reg = __m128d;
+				static constexpr size_t width = 2;
+				
+				static inline reg load(double const* p)		{ return _mm_loadu_pd(p); }
+				static inline void store(double* p, reg r)	{ _mm_storeu_pd(p, r); }
+				static inline reg broadcast(double v)		{ return _mm_set1_pd(v); }
+				
+				static inline reg add(reg a, reg b)			{ return _mm_add_pd(a, b); }
+				static inline reg sub(reg a, reg b)			{ return _mm_sub_pd(a, b); }
+				static inline reg mul(reg a, reg b)			{ return _mm_mul_pd(a, b); }
+				static inline reg div(reg a, reg b)			{ return _mm_div_pd(a, b); }
+				static inline reg sqrt(reg a)				{ return _mm_sqrt_pd(a); }
+				
+				static inline reg mask_nonzero(reg test, reg value)
+				{ return _mm_and_pd(_mm_cmpneq_pd(test, _mm_setzero_pd()), value); }
+				
+				static inline reg mask_not_nan(reg test, reg value)
+				{ return _mm_and_pd(_mm_cmpord_pd(test, test), value); }
+			};
+			
+			#endif
+			
+			// True if every one of the given types is the same type, and that type has a vectorized batch.
+			template<typename T, typename... Ts> static constexpr bool
+			accelerated = (std::is_same_v<T, Ts> && ...) && (batch<T>::width > 1);
+			
+			/**
+			 * Runs body<batch<T>>(i) for every full batch in [0, n), then body<scalar_batch<T>>(i) for each remaining element.
+			 * The body receives the batch type as its template argument, and the index of the first lane as its argument.
+			 */
+			template<typename T, typename Body> static inline void
+			for_each_batch(size_t n, Body&& body)
+			{
+				size_t i = 0;
+				
+				if constexpr (batch<T>::width > 1)
+				for (; i + batch<T>::width <= n; i += batch<T>::width)
+				{ body.template operator()< batch<T> >(i); }
+				
+				for (; i < n; i++)
+				{ body.template operator()< scalar_batch<T> >(i); }
+			}
+			
+		}
+		
+		
+		
+		/**
+		 * Structure-of-arrays counterpart to Vector2. The x and y components of every element live in two separate,
+		 * cache-line aligned columns, so bulk arithmetic over the whole array maps directly onto SIMD registers.
+		 *
+		 * Element access goes through operator[] (by value) and set(); whole columns are exposed as spans through xs() and ys().
+		 * For float and double columns the bulk operations run on SSE2/AVX kernels, and on plain loops for every other type.
+		 */
+		template<typename XT, typename YT = XT>
+		class Vector2Array
+		{
+			
+			public: using value_type = Vector2<XT, YT>;
+			
+			// Marks arrays as whole-vector operands, never as scalars applied to each component (see Vector2Scalar).
+			public: using vector2_operand = void;
+			
+			private: AlignedVector<XT> _x;
+			private: AlignedVector<YT> _y;
+			
+			// Default constructor. Empty array.
+			public:
+			Vector2Array() = default;
+			
+			// Array of n value-initialized vectors.
+			public: explicit
+			Vector2Array(size_t n):
+			_x(n), _y(n) {}
+			
+			// Array of n copies of v.
+			public:
+			Vector2Array(size_t n, value_type const& v):
+			_x(n, v.x), _y(n, v.y) {}
+			
+			// Conversion from an array-of-structs range.
+			public: explicit
+			Vector2Array(std::span<value_type const> aos):
+			_x(aos.size()), _y(aos.size())
+			{
+				for (size_t i = 0; i < aos.size(); i++)
+				{ _x[i] = aos[i].x; _y[i] = aos[i].y; }
+			}
+			
+			// Evaluates a lazy expression (see lazy()) in a single pass over both columns.
+			public: template<typename E> requires requires { typename E::vector2_array_expression; }
+			Vector2Array(E const& expression):
+			_x(expression.size()), _y(expression.size())
+			{ expression.store(xs(), ys()); }
+			
+			/**
+			 * Evaluates a lazy expression in a single pass over both columns, and resizes to its size first. The expression
+			 * may read this very array: every element is read before it is written, and the size can only shrink.
+			 */
+			public: template<typename E> requires requires { typename E::vector2_array_expression; } Vector2Array&
+			operator=(E const& expression)
+			{
+				resize(expression.size());
+				expression.store(xs(), ys());
+				return *this;
+			}
+			
+			public: size_t
+			size() const
+			{ return _x.size(); }
+			
+			public: bool
+			empty() const
+			{ return _x.empty(); }
+			
+			public: void
+			reserve(size_t n)
+			{ _x.reserve(n); _y.reserve(n); }
+			
+			public: void
+			resize(size_t n)
+			{ _x.resize(n); _y.resize(n); }
+			
+			public: void
+			clear()
+			{ _x.clear(); _y.clear(); }
+			
+			public: void
+			push_back(value_type const& v)
+			{ _x.push_back(v.x); _y.push_back(v.y); }
+			
+			// Returns a copy of the i-th vector.
+			public: value_type
+			operator[](size_t i) const
+			{ return value_type(_x[i], _y[i]); }
+			
+			// Overwrites the i-th vector.
+			public: void
+			set(size_t i, value_type const& v)
+			{ _x[i] = v.x; _y[i] = v.y; }
+			
+			// The column of x components.
+			public: std::span<XT>
+			xs()
+			{ return _x; }
+			
+			public: std::span<XT const>
+			xs() const
+			{ return _x; }
+			
+			// The column of y components.
+			public: std::span<YT>
+			ys()
+			{ return _y; }
+			
+			public: std::span<YT const>
+			ys() const
+			{ return _y; }
+			
+			// Conversion back into an array-of-structs.
+			public: std::vector<value_type>
+			to_vector() const
+			{
+				std::vector<value_type> out;
+				out.reserve(size());
+				for (size_t i = 0; i < size(); i++) out.emplace_back(_x[i], _y[i]);
+				return out;
+			}
+			
+		};
+		
+		
+		
+		namespace Vector2ArrayOps {
+			
+			// Column source reading element i of an array.
+			template<typename T> struct
+			column
+			{
+				T const* p;
+				
+				template<typename U> static constexpr bool vectorizable = std::is_same_v<T, U>;
+				
+				constexpr T const& get(size_t i) const { return p[i]; }
+				template<typename B> auto load(size_t i) const { return B::load(p + i); }
+			};
+			
+			// Column source repeating a single value.
+			template<typename T> struct
+			broadcast
+			{
+				T v;
+				
+				template<typename U> static constexpr bool vectorizable = std::is_same_v<T, U>;
+				
+				constexpr T const& get(size_t) const { return v; }
+				template<typename B> auto load(size_t) const { return B::broadcast(v); }
+			};
+			
+			template<typename T> static constexpr auto
+			source(std::span<T const> s)
+			{ return column<T>{ s.data() }; }
+			
+			template<typename T> static constexpr auto
+			source(T const& v)
+			{ return broadcast<T>{ v }; }
+			
+			struct Add
+			{
+				template<typename B, typename R> static auto simd(R a, R b) { return B::add(a, b); }
+				template<typename A, typename C> static constexpr auto scalar(A const& a, C const& b) { return a + b; }
+			};
+			
+			struct Sub
+			{
+				template<typename B, typename R> static auto simd(R a, R b) { return B::sub(a, b); }
+				template<typename A, typename C> static constexpr auto scalar(A const& a, C const& b) { return a - b; }
+			};
+			
+			struct Mul
+			{
+				template<typename B, typename R> static auto simd(R a, R b) { return B::mul(a, b); }
+				template<typename A, typename C> static constexpr auto scalar(A const& a, C const& b) { return a * b; }
+			};
+			
+			struct Div
+			{
+				template<typename B, typename R> static auto simd(R a, R b) { return B::div(a, b); }
+				template<typename A, typename C> static constexpr auto scalar(A const& a, C const& b) { return a / b; }
+			};
+			
+			// out[i] = Op(lhs[i], rhs[i]) for a single column, where either side may be a broadcast value.
+			template<typename Op, typename L, typename R, typename O, typename LS, typename RS> static inline void
+			apply(LS lhs, RS rhs, std::span<O> out)
+			{
+				if constexpr (simd::accelerated<L, R, O>)
+				{
+					simd::for_each_batch<O>(out.size(), [&]<typename B>(size_t i)
+					{ B::store(out.data() + i, Op::template simd<B>(lhs.template load<B>(i), rhs.template load<B>(i))); });
+				}
+				else
+				{
+					for (size_t i = 0; i < out.size(); i++) out[i] = Op::scalar(lhs.get(i), rhs.get(i));
+				}
+			}
+			
+			template<typename Op, typename X1, typename Y1, typename X2, typename Y2> static inline auto
+			apply(Vector2Array<X1, Y1> const& lhs, Vector2Array<X2, Y2> const& rhs)
+			{
+				using XR = decltype(Op::scalar(std::declval<X1>(), std::declval<X2>()));
+				using YR = decltype(Op::scalar(std::declval<Y1>(), std::declval<Y2>()));
+				
+				Vector2Array<XR, YR> out(lhs.size() < rhs.size() ? lhs.size() : rhs.size());
+				apply<Op, X1, X2, XR>(source(lhs.xs()), source(rhs.xs()), out.xs());
+				apply<Op, Y1, Y2, YR>(source(lhs.ys()), source(rhs.ys()), out.ys());
+				return out;
+			}
+			
+			template<typename Op, typename X1, typename Y1, typename X2, typename Y2> static inline auto
+			apply(Vector2Array<X1, Y1> const& lhs, Vector2<X2, Y2> const& rhs)
+			{
+				using XR = decltype(Op::scalar(std::declval<X1>(), std::declval<X2>()));
+				using YR = decltype(Op::scalar(std::declval<Y1>(), std::declval<Y2>()));
+				
+				Vector2Array<XR, YR> out(lhs.size());
+				apply<Op, X1, X2, XR>(source(lhs.xs()), source(rhs.x), out.xs());
+				apply<Op, Y1, Y2, YR>(source(lhs.ys()), source(rhs.y), out.ys());
+				return out;
+			}
+			
+			template<typename Op, typename X1, typename Y1, typename X2, typename Y2> static inline auto
+			apply(Vector2<X1, Y1> const& lhs, Vector2Array<X2, Y2> const& rhs)
+			{
+				using XR = decltype(Op::scalar(std::declval<X1>(), std::declval<X2>()));
+				using YR = decltype(Op::scalar(std::declval<Y1>(), std::declval<Y2>()));
+				
+				Vector2Array<XR, YR> out(rhs.size());
+				apply<Op, X1, X2, XR>(source(lhs.x), source(rhs.xs()), out.xs());
+				apply<Op, Y1, Y2, YR>(source(lhs.y), source(rhs.ys()), out.ys());
+				return out;
+			}
+			
+			/**
+			 * In-place variant; lhs[i] = Op(lhs[i], rhs[i]) for every i < n, which must not exceed lhs.size(). Given the size
+			 * of a shorter array on the right, as the binary operators do, the vectors of lhs past it are left as they are.
+			 */
+			template<typename Op, typename X1, typename Y1, typename RX, typename RY> static inline void
+			apply_in_place(Vector2Array<X1, Y1>& lhs, RX const& rhs_x, RY const& rhs_y, size_t n)
+			{
+				apply<Op, X1, std::remove_cvref_t<decltype(rhs_x.get(0))>, X1>(source(std::as_const(lhs).xs().first(n)), rhs_x, lhs.xs().first(n));
+				apply<Op, Y1, std::remove_cvref_t<decltype(rhs_y.get(0))>, Y1>(source(std::as_const(lhs).ys().first(n)), rhs_y, lhs.ys().first(n));
+			}
+			
+			// Any operand that is applied component-wise to every vector, e.g. a float.
+			template<typename T> concept
+			Scalar = Vector2Scalar<T>;
+			
+		}
+		
+		
+		
+		#define INK_VECTOR2_ARRAY_OPERATOR(sym, Op)																				\
+			template<typename X1, typename Y1, typename X2, typename Y2> static inline auto									\
+			operator sym(Vector2Array<X1, Y1> const& lhs, Vector2Array<X2, Y2> const& rhs)									\
+			{ return Vector2ArrayOps::apply<Vector2ArrayOps::Op>(lhs, rhs); }												\
+																															\
+			template<typename X1, typename Y1, typename X2, typename Y2> static inline auto									\
+			operator sym(Vector2Array<X1, Y1> const& lhs, Vector2<X2, Y2> const& rhs)										\
+			{ return Vector2ArrayOps::apply<Vector2ArrayOps::Op>(lhs, rhs); }												\
+																															\
+			template<typename X1, typename Y1, typename X2, typename Y2> static inline auto									\
+			operator sym(Vector2<X1, Y1> const& lhs, Vector2Array<X2, Y2> const& rhs)										\
+			{ return Vector2ArrayOps::apply<Vector2ArrayOps::Op>(lhs, rhs); }												\
+																															\
+			template<Vector2ArrayOps::Scalar T, typename X, typename Y> static inline auto									\
+			operator sym(Vector2Array<X, Y> const& lhs, T const& rhs)														\
+			{ return Vector2ArrayOps::apply<Vector2ArrayOps::Op>(lhs, Vector2<T, T>(rhs, rhs)); }							\
+																															\
+			template<Vector2ArrayOps::Scalar T, typename X, typename Y> static inline auto									\
+			operator sym(T const& lhs, Vector2Array<X, Y> const& rhs)														\
+			{ return Vector2ArrayOps::apply<Vector2ArrayOps::Op>(Vector2<T, T>(lhs, lhs), rhs); }							\
+																															\
+			template<typename X1, typename Y1, typename X2, typename Y2> static inline auto&								\
+			operator sym##=(Vector2Array<X1, Y1>& lhs, Vector2Array<X2, Y2> const& rhs)										\
+			{																												\
+				const size_t n = lhs.size() < rhs.size() ? lhs.size() : rhs.size();										\
+				Vector2ArrayOps::apply_in_place<Vector2ArrayOps::Op>(lhs, Vector2ArrayOps::source(rhs.xs()), Vector2ArrayOps::source(rhs.ys()), n);	\
+				return lhs;																									\
+			}																												\
+																															\
+			template<typename X1, typename Y1, typename X2, typename Y2> static inline auto&								\
+			operator sym##=(Vector2Array<X1, Y1>& lhs, Vector2<X2, Y2> const& rhs)											\
+			{ Vector2ArrayOps::apply_in_place<Vector2ArrayOps::Op>(lhs, Vector2ArrayOps::source(rhs.x), Vector2ArrayOps::source(rhs.y), lhs.size()); return lhs; }	\
+																															\
+			template<Vector2ArrayOps::Scalar T, typename X, typename Y> static inline auto&									\
+			operator sym##=(Vector2Array<X, Y>& lhs, T const& rhs)															\
+			{ Vector2ArrayOps::apply_in_place<Vector2ArrayOps::Op>(lhs, Vector2ArrayOps::source(X(rhs)), Vector2ArrayOps::source(Y(rhs)), lhs.size()); return lhs; }
+		
+		INK_VECTOR2_ARRAY_OPERATOR(+, Add)
+		INK_VECTOR2_ARRAY_OPERATOR(-, Sub)
+		INK_VECTOR2_ARRAY_OPERATOR(*, Mul)
+		INK_VECTOR2_ARRAY_OPERATOR(/, Div)
+		
+		#undef INK_VECTOR2_ARRAY_OPERATOR
+		
+		
+		
+		namespace Vector2ArrayOps {
+			
+			// Column source applying Op to the elements of two other sources, one element or one batch at a time.
+			template<typename Op, typename L, typename R> struct
+			fused
+			{
+				L l;
+				R r;
+				
+				template<typename U> static constexpr bool vectorizable = L::template vectorizable<U> && R::template vectorizable<U>;
+				
+				constexpr auto get(size_t i) const { return Op::scalar(l.get(i), r.get(i)); }
+				template<typename B> auto load(size_t i) const { return Op::template simd<B>(l.template load<B>(i), r.template load<B>(i)); }
+			};
+			
+			// A lazy expression over whole arrays (see lazy()): one source per column, spanning n vectors.
+			template<typename XS, typename YS> struct
+			expression
+			{
+				using vector2_operand = void;
+				using vector2_array_expression = void;
+				
+				XS x;
+				YS y;
+				size_t n;
+				
+				constexpr size_t size() const { return n; }
+				
+				/**
+				 * Writes every element of the expression to xs and ys, both columns in the same loop. Batched when every column
+				 * and value in a column is of the type of its output and that type has a vectorized batch; a scalar of another
+				 * type (e.g. a double on float arrays) keeps that column on the plain loop, with its usual conversions.
+				 */
+				template<typename X, typename Y> void
+				store(std::span<X> xs, std::span<Y> ys) const
+				{
+					if constexpr (simd::accelerated<X, Y> && XS::template vectorizable<X> && YS::template vectorizable<Y>)
+					{
+						simd::for_each_batch<X>(n, [&]<typename B>(size_t i)
+						{
+							B::store(xs.data() + i, x.template load<B>(i));
+							B::store(ys.data() + i, y.template load<B>(i));
+						});
+					}
+					else
+					{
+						for (size_t i = 0; i < n; i++) { xs[i] = x.get(i); ys[i] = y.get(i); }
+					}
+				}
+			};
+			
+			template<typename T> concept
+			ArrayExpression = requires { typename std::remove_cvref_t<T>::vector2_array_expression; };
+			
+			// The expression standing for an operand. Vector2s and scalars span any number of vectors.
+			template<ArrayExpression E> static constexpr auto
+			array_operand(E const& e)
+			{ return e; }
+			
+			template<typename X, typename Y> static constexpr auto
+			array_operand(Vector2Array<X, Y> const& a)
+			{ return expression<column<X>, column<Y>>{ source(a.xs()), source(a.ys()), a.size() }; }
+			
+			template<typename X, typename Y> static constexpr auto
+			array_operand(Vector2<X, Y> const& v)
+			{ return expression<broadcast<X>, broadcast<Y>>{ source(v.x), source(v.y), SIZE_MAX }; }
+			
+			// A lazy Vector2 expression is evaluated once, up front, rather than for every element.
+			template<Vector2Lazy::Expression E> static constexpr auto
+			array_operand(E const& e)
+			{ return array_operand(Vector2(e)); }
+			
+			template<Scalar T> static constexpr auto
+			array_operand(T const& s)
+			{ return expression<broadcast<T>, broadcast<T>>{ source(s), source(s), SIZE_MAX }; }
+			
+			// Anything that may join a lazy array expression: another one, an array, a Vector2 (or lazy one), or a scalar.
+			template<typename T> concept
+			ArrayOperand = requires(T const& t) { array_operand(t); };
+			
+			#define INK_VECTOR2_ARRAY_LAZY_OPERATOR(sym, Op)																		\
+				template<ArrayOperand L, ArrayOperand R> requires (ArrayExpression<L> || ArrayExpression<R>) static constexpr auto	\
+				operator sym(L const& lhs, R const& rhs)																		\
+				{																												\
+					auto l = array_operand(lhs); auto r = array_operand(rhs);													\
+					return expression<fused<Op, decltype(l.x), decltype(r.x)>, fused<Op, decltype(l.y), decltype(r.y)>>			\
+					{ { l.x, r.x }, { l.y, r.y }, l.n < r.n ? l.n : r.n };														\
+				}
+			
+			INK_VECTOR2_ARRAY_LAZY_OPERATOR(+, Add)
+			INK_VECTOR2_ARRAY_LAZY_OPERATOR(-, Sub)
+			INK_VECTOR2_ARRAY_LAZY_OPERATOR(*, Mul)
+			INK_VECTOR2_ARRAY_LAZY_OPERATOR(/, Div)
+			
+			#undef INK_VECTOR2_ARRAY_LAZY_OPERATOR
+		
+		}
+		
+		template<typename E> requires requires { typename E::vector2_array_expression; }
+		Vector2Array(E const&) -> Vector2Array<std::remove_cvref_t<decltype(std::declval<E const&>().x.get(0))>, std::remove_cvref_t<decltype(std::declval<E const&>().y.get(0))>>;
+		
+		/**
+		 * Starts a lazy expression over a whole array. Arithmetic on it (+ - * /), with arrays, Vector2s, scalars or other
+		 * lazy expressions, builds a tree of operations instead of an array per step; the tree is evaluated when converted or
+		 * assigned to a Vector2Array, in a single loop (vectorized, for float and double) with no arrays in between:
+		 *
+		 * 	Vector2Array r = ink::lazy(a) * 2.0f + b - c;	// One pass over a, b, c and r, rather than three and two temporaries.
+		 *
+		 * As with lazy(Vector2), the tree refers to its operands, so it must be evaluated within the full expression that builds it.
+		 */
+		template<typename X, typename Y> static inline auto
+		lazy(Vector2Array<X, Y> const& a)
+		{ return Vector2ArrayOps::array_operand(a); }
+		
+		
+		
+		/**
+		 * Bulk dot product; out[i] = lhs[i].dot(rhs[i]).
+		 * out must hold at least as many elements as the shorter of the two arrays.
+		 */
+		template<typename X1, typename Y1, typename X2, typename Y2, typename O> static inline void
+		dot(Vector2Array<X1, Y1> const& lhs, Vector2Array<X2, Y2> const& rhs, std::span<O> out)
+		{
+			const size_t n = lhs.size() < rhs.size() ? lhs.size() : rhs.size();
+			auto ax = lhs.xs().data(); auto ay = lhs.ys().data();
+			auto bx = rhs.xs().data(); auto by = rhs.ys().data();
+			
+			if constexpr (simd::accelerated<X1, Y1, X2, Y2, O>)
+			{
+				simd::for_each_batch<O>(n, [&]<typename B>(size_t i)
+				{ B::store(out.data() + i, B::add(B::mul(B::load(ax + i), B::load(bx + i)), B::mul(B::load(ay + i), B::load(by + i)))); });
+			}
+			else
+			{
+				for (size_t i = 0; i < n; i++) out[i] = (ax[i] * bx[i]) + (ay[i] * by[i]);
+			}
+		}
+		
+		/**
+		 * Bulk cross product; out[i] = lhs[i].cross(rhs[i]).
+		 * out must hold at least as many elements as the shorter of the two arrays.
+		 */
+		template<typename X1, typename Y1, typename X2, typename Y2, typename O> static inline void
+		cross(Vector2Array<X1, Y1> const& lhs, Vector2Array<X2, Y2> const& rhs, std::span<O> out)
+		{
+			const size_t n = lhs.size() < rhs.size() ? lhs.size() : rhs.size();
+			auto ax = lhs.xs().data(); auto ay = lhs.ys().data();
+			auto bx = rhs.xs().data(); auto by = rhs.ys().data();
+			
+			if constexpr (simd::accelerated<X1, Y1, X2, Y2, O>)
+			{
+				simd::for_each_batch<O>(n, [&]<typename B>(size_t i)
+				{ B::store(out.data() + i, B::sub(B::mul(B::load(ax + i), B::load(by + i)), B::mul(B::load(ay + i), B::load(bx + i)))); });
+			}
+			else
+			{
+				for (size_t i = 0; i < n; i++) out[i] = (ax[i] * by[i]) - (ay[i] * bx[i]);
+			}
+		}
+		
+		/**
+		 * Bulk squared magnitude; out[i] = v[i].magnitude2().
+		 * out must hold at least v.size() elements.
+		 */
+		template<typename X, typename Y, typename O> static inline void
+		magnitude2(Vector2Array<X, Y> const& v, std::span<O> out)
+		{
+			auto x = v.xs().data(); auto y = v.ys().data();
+			
+			if constexpr (simd::accelerated<X, Y, O>)
+			{
+				simd::for_each_batch<O>(v.size(), [&]<typename B>(size_t i)
+				{
+					auto vx = B::load(x + i), vy = B::load(y + i);
+					B::store(out.data() + i, B::add(B::mul(vx, vx), B::mul(vy, vy)));
+				});
+			}
+			else
+			{
+				for (size_t i = 0; i < v.size(); i++) out[i] = (x[i] * x[i]) + (y[i] * y[i]);
+			}
+		}
+		
+		/**
+		 * Bulk magnitude; out[i] = v[i].magnitude().
+		 * out must hold at least v.size() elements.
+		 */
+		template<typename X, typename Y, typename O> static inline void
+		magnitude(Vector2Array<X, Y> const& v, std::span<O> out)
+		{
+			auto x = v.xs().data(); auto y = v.ys().data();
+			
+			if constexpr (simd::accelerated<X, Y, O>)
+			{
+				simd::for_each_batch<O>(v.size(), [&]<typename B>(size_t i)
+				{
+					auto vx = B::load(x + i), vy = B::load(y + i);
+					B::store(out.data() + i, B::sqrt(B::add(B::mul(vx, vx), B::mul(vy, vy))));
+				});
+			}
+			else
+			{
+				for (size_t i = 0; i < v.size(); i++) out[i] = std::sqrt((x[i] * x[i]) + (y[i] * y[i]));
+			}
+		}
+		
+		/**
+		 * Bulk normalization, in place; v[i] = v[i].normalize().
+		 * As with Vector2::normalize(), zero-length vectors are left as (0,0).
+		 */
+		template<typename X, typename Y> static inline void
+		normalize(Vector2Array<X, Y>& v)
+		{
+			auto x = v.xs().data(); auto y = v.ys().data();
+			
+			if constexpr (simd::accelerated<X, Y>)
+			{
+				simd::for_each_batch<X>(v.size(), [&]<typename B>(size_t i)
+				{
+					auto vx = B::load(x + i), vy = B::load(y + i);
+					auto len = B::sqrt(B::add(B::mul(vx, vx), B::mul(vy, vy)));
+					B::store(x + i, B::mask_nonzero(len, B::div(vx, len)));
+					B::store(y + i, B::mask_nonzero(len, B::div(vy, len)));
+				});
+			}
+			else
+			{
+				for (size_t i = 0; i < v.size(); i++) v.set(i, v[i].normalize());
+			}
+		}
+		
+		// Normalized copy of every vector in v.
+		template<typename X, typename Y> static inline auto
+		normalized(Vector2Array<X, Y> v)
+		{ normalize(v); return v; }
+		
+		
+		
+		namespace simd {
+			
+			// Instruction set levels the batch Q_rsqrt kernels are available for, in ascending order.
+			enum class level { scalar, sse2, avx2, avx512 };
+			
+			// Highest instruction set level supported by both the running CPU and the OS. Queried once.
+			static inline level
+			detected_level()
+			{
+				static const level detected = []
+				{
+					#if defined(INK_VECTOR2_ARRAY_X86) && (defined(__GNUC__) || defined(__clang__))
+						__builtin_cpu_init();
+						if (__builtin_cpu_supports("avx512f")) return level::avx512;
+						if (__builtin_cpu_supports("avx2")) return level::avx2;
+						if (__builtin_cpu_supports("sse2")) return level::sse2;
+					#elif defined(INK_VECTOR2_ARRAY_X86) && defined(_MSC_VER)
+						int info[4];
+						__cpuid(info, 0);
+						const int max_leaf = info[0];
+						__cpuid(info, 1);
+						const bool sse2 = info[3] & (1 << 26);
+						const bool osxsave = info[2] & (1 << 27);
+						const unsigned long long xcr0 = osxsave ? _xgetbv(0) : 0;
+						int leaf7[4] = {};
+						if (max_leaf >= 7) __cpuidex(leaf7, 7, 0);
+						if ((leaf7[1] & (1 << 16)) && (xcr0 & 0xE6) == 0xE6) return level::avx512;
+						if ((leaf7[1] & (1 << 5)) && (xcr0 & 0x6) == 0x6) return level::avx2;
+						if (sse2) return level::sse2;
+					#endif
+					return level::scalar;
+				}();
+				return detected;
+			}
+			
+			// Scalar Q_rsqrt over [begin, n); also handles the tail of every vector kernel.
+			static inline void
+			q_rsqrt_scalar(float const* in, float* out, size_t begin, size_t n, size_t extra_iterations)
+			{
+				for (size_t i = begin; i < n; i++)
+				{ out[i] = Q_rsqrt_impl<float>::Q_rsqrt(in[i], extra_iterations); }
+			}
+			
+			#if defined(INK_VECTOR2_ARRAY_X86)
+			
+			// The vector kernels evaluate the Newton step in the same order as Q_rsqrt_impl. Lanes agree with the scalar result up to
+			// the last bit or so, where the compiler contracts the step into an FMA on targets that have one.
+			
+			INK_VECTOR2_ARRAY_TARGET("sse2") static inline void
+			q_rsqrt_sse2(float const* in, float* out, size_t n, size_t extra_iterations)
+			{
+				const __m128i MAGIC_NUM = _mm_set1_epi32(0x5f3759df);
+				const __m128 HALF = _mm_set1_ps(0.5F), THREE_HALVES = _mm_set1_ps(1.5F);
+				
+				size_t i = 0;
+				for (; i + 4 <= n; i += 4)
+				{
+					const __m128 number = _mm_loadu_ps(in + i);
+					const __m128 x2 = _mm_mul_ps(number, HALF);
+					__m128 y = _mm_castsi128_ps(_mm_sub_epi32(MAGIC_NUM, _mm_srli_epi32(_mm_castps_si128(number), 1)));
+					
+					y = _mm_mul_ps(y, _mm_sub_ps(THREE_HALVES, _mm_mul_ps(_mm_mul_ps(x2, y), y)));
+					for (size_t n_iteration = 0; n_iteration < extra_iterations; n_iteration++)
+					{ y = _mm_mul_ps(y, _mm_sub_ps(THREE_HALVES, _mm_mul_ps(_mm_mul_ps(x2, y), y))); }
+					
+					_mm_storeu_ps(out + i, y);
+				}
+				q_rsqrt_scalar(in, out, i, n, extra_iterations);
+			}
+			
+			INK_VECTOR2_ARRAY_TARGET("avx2") static inline void
+			q_rsqrt_avx2(float const* in, float* out, size_t n, size_t extra_iterations)
+			{
+				const __m256i MAGIC_NUM = _mm256_set1_epi32(0x5f3759df);
+				const __m256 HALF = _mm256_set1_ps(0.5F), THREE_HALVES = _mm256_set1_ps(1.5F);
+				
+				size_t i = 0;
+				for (; i + 8 <= n; i += 8)
+				{
+					const __m256 number = _mm256_loadu_ps(in + i);
+					const __m256 x2 = _mm256_mul_ps(number, HALF);
+					__m256 y = _mm256_castsi256_ps(_mm256_sub_epi32(MAGIC_NUM, _mm256_srli_epi32(_mm256_castps_si256(number), 1)));
+					
+					y = _mm256_mul_ps(y, _mm256_sub_ps(THREE_HALVES, _mm256_mul_ps(_mm256_mul_ps(x2, y), y)));
+					for (size_t n_iteration = 0; n_iteration < extra_iterations; n_iteration++)
+					{ y = _mm256_mul_ps(y, _mm256_sub_ps(THREE_HALVES, _mm256_mul_ps(_mm256_mul_ps(x2, y), y))); }
+					
+					_mm256_storeu_ps(out + i, y);
+				}
+				q_rsqrt_scalar(in, out, i, n, extra_iterations);
+			}
+			
+			INK_VECTOR2_ARRAY_TARGET("avx512f") static inline void
+			q_rsqrt_avx512(float const* in, float* out, size_t n, size_t extra_iterations)
+			{
+				const __m512i MAGIC_NUM = _mm512_set1_epi32(0x5f3759df);
+				const __m512 HALF = _mm512_set1_ps(0.5F), THREE_HALVES = _mm512_set1_ps(1.5F);
+				
+				// The zero-masked shift is used over _mm512_srli_epi32, whose undefined passthrough trips -Wmaybe-uninitialized on GCC.
+				
+				size_t i = 0;
+				for (; i + 16 <= n; i += 16)
+				{
+					const __m512 number = _mm512_loadu_ps(in + i);
+					const __m512 x2 = _mm512_mul_ps(number, HALF);
+					__m512 y = _mm512_castsi512_ps(_mm512_sub_epi32(MAGIC_NUM, _mm512_maskz_srli_epi32(__mmask16(~0), _mm512_castps_si512(number), 1)));
+					
+					y = _mm512_mul_ps(y, _mm512_sub_ps(THREE_HALVES, _mm512_mul_ps(_mm512_mul_ps(x2, y), y)));
+					for (size_t n_iteration = 0; n_iteration < extra_iterations; n_iteration++)
+					{ y = _mm512_mul_ps(y, _mm512_sub_ps(THREE_HALVES, _mm512_mul_ps(_mm512_mul_ps(x2, y), y))); }
+					
+					_mm512_storeu_ps(out + i, y);
+				}
+				q_rsqrt_scalar(in, out, i, n, extra_iterations);
+			}
+			
+			#endif
+			
+			// Runs the widest Q_rsqrt kernel the running CPU supports over n elements. in and out may alias exactly.
+			static inline void
+			q_rsqrt(float const* in, float* out, size_t n, size_t extra_iterations)
+			{
+				switch (detected_level())
+				{
+					#if defined(INK_VECTOR2_ARRAY_X86)
+					case level::avx512:	return q_rsqrt_avx512(in, out, n, extra_iterations);
+					case level::avx2:	return q_rsqrt_avx2(in, out, n, extra_iterations);
+					case level::sse2:	return q_rsqrt_sse2(in, out, n, extra_iterations);
+					#endif
+					default:			return q_rsqrt_scalar(in, out, 0, n, extra_iterations);
+				}
+			}
+			
+		}
+		
+	}
+	
+	using detail::Vector2Array;
+	using detail::lazy;
+	
+	using detail::dot;
+	using detail::cross;
+	using detail::magnitude2;
+	using detail::magnitude;
+	using detail::normalize;
+	using detail::normalized;
+	
+	/**
+	 * Batch Q_rsqrt; out[i] = Q_rsqrt(in[i], extra_iterations) for every element of in.
+	 * Processes 4, 8 or 16 lanes at once, depending on whether the running CPU supports SSE2, AVX2 or AVX-512.
+	 * out must hold at least in.size() elements, and may be the same span as in.
+	 */
+	static inline void
+	Q_rsqrt(std::span<float const> in, std::span<float> out, size_t extra_iterations = 0)
+	{ detail::simd::q_rsqrt(in.data(), out.data(), in.size(), extra_iterations); }
+	
+	/**
+	 * Bulk normalization utilizing the batch Q_rsqrt, in place; v[i] = v[i].q_normalize(extra_iterations).
+	 */
+	static inline void
+	q_normalize(Vector2Array<float>& v, size_t extra_iterations = 0)
+	{
+		constexpr size_t CHUNK = 256;
+		alignas(64) float rsqrt[CHUNK];
+		
+		for (size_t begin = 0; begin < v.size(); begin += CHUNK)
+		{
+			const size_t n = (v.size() - begin < CHUNK) ? v.size() - begin : CHUNK;
+			auto x = v.xs().data() + begin; auto y = v.ys().data() + begin;
+			
+			detail::simd::for_each_batch<float>(n, [&]<typename B>(size_t i)
+			{
+				auto vx = B::load(x + i), vy = B::load(y + i);
+				B::store(rsqrt + i, B::add(B::mul(vx, vx), B::mul(vy, vy)));
+			});
+			
+			detail::simd::q_rsqrt(rsqrt, rsqrt, n, extra_iterations);
+			
+			detail::simd::for_each_batch<float>(n, [&]<typename B>(size_t i)
+			{
+				auto r = B::load(rsqrt + i);
+				B::store(x + i, B::mask_not_nan(r, B::mul(B::load(x + i), r)));
+				B::store(y + i, B::mask_not_nan(r, B::mul(B::load(y + i), r)));
+			});
+		}
+	}
+	
+	/**
+	 * Array-of-structs counterpart of the above, in place; v[i] = v[i].q_normalize(extra_iterations).
+	 */
+	static inline void
+	q_normalize(std::span<Vector2<float>> v, size_t extra_iterations = 0)
+	{
+		constexpr size_t CHUNK = 256;
+		alignas(64) float rsqrt[CHUNK];
+		
+		for (size_t begin = 0; begin < v.size(); begin += CHUNK)
+		{
+			const size_t n = (v.size() - begin < CHUNK) ? v.size() - begin : CHUNK;
+			auto chunk = v.subspan(begin, n);
+			
+			for (size_t i = 0; i < n; i++) rsqrt[i] = chunk[i].magnitude2();
+			
+			detail::simd::q_rsqrt(rsqrt, rsqrt, n, extra_iterations);
+			
+			for (size_t i = 0; i < n; i++)
+			{ chunk[i] = isnan(rsqrt[i]) ? Vector2<float>(0, 0) : Vector2<float>(chunk[i].x * rsqrt[i], chunk[i].y * rsqrt[i]); }
+		}
+	}
+	
+}
+
+#endif